@@ -0,0 +1,140 @@
+/*
+ * benchmark_image.cpp
+ * Evolve - Image rendering benchmark
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "../src/environments/image/image.h"
+#include "benchmark.h"
+#include "../src/generic.h"
+#include <vector>
+
+//
+// Constants
+//
+
+// Size of the rendered image
+const int IMAGE_WIDTH = 256;
+const int IMAGE_HEIGHT = 256;
+
+// Amount of distinct polygons to cycle through
+const int POLYGONS = 64;
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Environment which only renders, without a reference image
+class EnvImgRender : public EnvImage {
+public:
+    // Construction & destruction
+    EnvImgRender(int inputWidth, int inputHeight) {
+        dataInputWidth = inputWidth;
+        dataInputHeight = inputHeight;
+    }
+
+    // Required functions
+    void update(const DNA* inputDNA) {
+    }
+    bool condition() {
+        return false;
+    }
+    Environment* clone() const {
+        return new EnvImgRender(*this);
+    }
+};
+
+
+
+//////////
+// MAIN //
+//////////
+
+
+int main() {
+    //
+    // Configure
+    //
+
+    Benchmark benchmark;
+    EnvImgRender tempEnvironment(IMAGE_WIDTH, IMAGE_HEIGHT);
+
+    // Generate single-polygon DNA strings (a colour code and 3 or 4 points)
+    random_seed(0);
+    std::vector<DNA> tempPolygons;
+    for (int i = 0; i < POLYGONS; i++) {
+        unsigned char tempGene[12];
+        unsigned int tempSize = 4 + 2*random_int(3, 5);
+        random_fill(tempGene, tempSize, 1, 255);
+        tempPolygons.push_back(DNA(tempGene, tempSize));
+    }
+
+    // Target surface
+    cairo_surface_t* tempSurface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, IMAGE_WIDTH, IMAGE_HEIGHT);
+    cairo_t* tempContext = cairo_create(tempSurface);
+
+
+    //
+    // Cairo
+    //
+
+    benchmark.init("polygons rendered by Cairo");
+    int i = 0;
+    benchmark.start();
+    while (benchmark.next()) {
+        tempEnvironment.draw(tempContext, &tempPolygons[i++]);
+        i %= POLYGONS;
+    }
+    cairo_surface_flush(tempSurface);
+    benchmark.stop();
+
+    benchmark.print();
+
+
+    //
+    // Native rasteriser
+    //
+
+    benchmark.init("polygons rendered by the native rasteriser");
+    Raster tempRaster;
+    tempRaster.setTarget(cairo_image_surface_get_data(tempSurface), IMAGE_WIDTH, IMAGE_HEIGHT, cairo_image_surface_get_stride(tempSurface));
+    i = 0;
+    benchmark.start();
+    while (benchmark.next()) {
+        tempEnvironment.draw(tempRaster, &tempPolygons[i++]);
+        i %= POLYGONS;
+    }
+    benchmark.stop();
+
+    benchmark.print();
+
+    cairo_destroy(tempContext);
+    cairo_surface_destroy(tempSurface);
+}
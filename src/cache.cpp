@@ -0,0 +1,191 @@
+/*
+ * cache.cpp
+ * Evolve - Fitness cache
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "cache.h"
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Construction and destruction
+//
+
+// Constructor with given environment and capacity
+EnvCache::EnvCache(Environment* inputEnvironment, unsigned int inputCapacity) : dataStorage(new Storage()) {
+    dataEnvironment = inputEnvironment;
+    dataOwner = false;
+    dataStorage->capacity = inputCapacity;
+    dataStorage->hits = 0;
+    dataStorage->misses = 0;
+}
+
+// Constructor for clones, sharing the storage
+EnvCache::EnvCache(Environment* inputEnvironment, std::shared_ptr<Storage> inputStorage) : dataStorage(inputStorage) {
+    dataEnvironment = inputEnvironment;
+    dataOwner = true;
+}
+
+// Destructor
+EnvCache::~EnvCache() {
+    if (dataOwner)
+        delete dataEnvironment;
+}
+
+// Storage destructor
+EnvCache::Storage::~Storage() {
+    std::unordered_map<uint64_t, Entry*>::iterator it;
+    for (it = entries.begin(); it != entries.end(); it++)
+        delete it->second;
+}
+
+
+//
+// Required functions
+//
+
+// Fitness of a single DNA string
+double EnvCache::fitness(const DNA* inputDNA) {
+    uint64_t tempHash = inputDNA->hash();
+    double tempFitness;
+    if (lookup(inputDNA, tempHash, tempFitness))
+        return tempFitness;
+
+    tempFitness = dataEnvironment->fitness(inputDNA);
+    store(inputDNA, tempHash, tempFitness);
+    return tempFitness;
+}
+
+// Fitness of a batch of DNA strings
+//   only the strings missing from the cache are passed on, in one batch
+void EnvCache::fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize) {
+    // Look up all strings
+    std::vector<uint64_t> tempHashes(inputSize);
+    std::vector<unsigned int> tempMisses;
+    std::vector<const DNA*> tempDNA;
+    for (unsigned int i = 0; i < inputSize; i++) {
+        tempHashes[i] = inputDNA[i]->hash();
+        if (!lookup(inputDNA[i], tempHashes[i], outputFitness[i])) {
+            tempMisses.push_back(i);
+            tempDNA.push_back(inputDNA[i]);
+        }
+    }
+    if (tempMisses.empty())
+        return;
+
+    // Evaluate the missing ones
+    std::vector<double> tempFitness(tempMisses.size());
+    dataEnvironment->fitness(&tempDNA[0], &tempFitness[0], tempMisses.size());
+    for (unsigned int i = 0; i < tempMisses.size(); i++) {
+        outputFitness[tempMisses[i]] = tempFitness[i];
+        store(tempDNA[i], tempHashes[tempMisses[i]], tempFitness[i]);
+    }
+}
+
+// Forwarded functions
+int EnvCache::alphabet() const {
+    return dataEnvironment->alphabet();
+}
+void EnvCache::update(const DNA* inputDNA) {
+    dataEnvironment->update(inputDNA);
+}
+bool EnvCache::condition() {
+    return dataEnvironment->condition();
+}
+
+// Clone the wrapped environment, but share the cache
+Environment* EnvCache::clone() const {
+    Environment* tempClone = dataEnvironment->clone();
+    if (tempClone == 0)
+        return 0;
+    return new EnvCache(tempClone, dataStorage);
+}
+
+
+//
+// Statistics
+//
+
+unsigned long EnvCache::hits() const {
+    std::lock_guard<std::mutex> tempLock(dataStorage->mutex);
+    return dataStorage->hits;
+}
+
+unsigned long EnvCache::misses() const {
+    std::lock_guard<std::mutex> tempLock(dataStorage->mutex);
+    return dataStorage->misses;
+}
+
+
+//
+// Cache access
+//
+
+// Look up a DNA string
+bool EnvCache::lookup(const DNA* inputDNA, uint64_t inputHash, double& outputFitness) {
+    std::lock_guard<std::mutex> tempLock(dataStorage->mutex);
+    std::unordered_map<uint64_t, Entry*>::iterator it = dataStorage->entries.find(inputHash);
+    if (it != dataStorage->entries.end() && it->second->dna == *inputDNA) {
+        outputFitness = it->second->fitness;
+        dataStorage->hits++;
+        return true;
+    }
+    dataStorage->misses++;
+    return false;
+}
+
+// Store the fitness of a DNA string
+//   a colliding entry gets replaced, and when the cache is full the oldest
+//   entry is evicted; a capacity of 0 disables storing altogether
+void EnvCache::store(const DNA* inputDNA, uint64_t inputHash, double inputFitness) {
+    std::lock_guard<std::mutex> tempLock(dataStorage->mutex);
+    if (dataStorage->capacity == 0)
+        return;
+    std::unordered_map<uint64_t, Entry*>::iterator it = dataStorage->entries.find(inputHash);
+    if (it != dataStorage->entries.end()) {
+        it->second->dna = *inputDNA;
+        it->second->fitness = inputFitness;
+        return;
+    }
+
+    // Evict the oldest entry
+    if (dataStorage->entries.size() >= dataStorage->capacity && !dataStorage->order.empty()) {
+        it = dataStorage->entries.find(dataStorage->order.front());
+        delete it->second;
+        dataStorage->entries.erase(it);
+        dataStorage->order.pop_front();
+    }
+
+    dataStorage->entries[inputHash] = new Entry(*inputDNA, inputFitness);
+    dataStorage->order.push_back(inputHash);
+}
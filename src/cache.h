@@ -0,0 +1,117 @@
+/*
+ * cache.h
+ * Evolve - Fitness cache
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __CACHE
+#define __CACHE
+
+// Headers
+#include "environment.h"
+#include "dna.h"
+#include <unordered_map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <memory>
+
+
+
+//
+// Constants
+//
+
+// Default amount of cached fitness values
+const unsigned int CACHE_CAPACITY = 4096;
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Fitness cache
+//   wraps an environment, and remembers the fitness of recently evaluated
+//   DNA strings; entries are looked up by hash, and compared in full to
+//   rule out collisions. Clones share the cache, so it can be used together
+//   with the threaded evaluators. Only wrap deterministic environments: a
+//   cached score of a stochastic one (e.g. tetris, which draws random pieces)
+//   would freeze whatever a single lucky evaluation yielded.
+class EnvCache : public Environment
+{
+    public:
+        // Construction and destruction
+        EnvCache(Environment* inputEnvironment, unsigned int inputCapacity = CACHE_CAPACITY);
+        ~EnvCache();
+
+        // Required functions
+        double fitness(const DNA* inputDNA);
+        void fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize);
+        int alphabet() const;
+        void update(const DNA* inputDNA);
+        bool condition();
+        Environment* clone() const;
+
+        // Statistics
+        unsigned long hits() const;
+        unsigned long misses() const;
+
+    protected:
+        // Cache access (by given hash, so collisions can be tested)
+        bool lookup(const DNA* inputDNA, uint64_t inputHash, double& outputFitness);
+        void store(const DNA* inputDNA, uint64_t inputHash, double inputFitness);
+
+    private:
+        // Shared storage
+        struct Entry {
+            Entry(const DNA& inputDNA, double inputFitness) : dna(inputDNA), fitness(inputFitness) {}
+            DNA dna;
+            double fitness;
+        };
+        struct Storage {
+            std::mutex mutex;
+            std::unordered_map<uint64_t, Entry*> entries;
+            std::deque<uint64_t> order;
+            unsigned int capacity;
+            unsigned long hits, misses;
+            ~Storage();
+        };
+
+        // Construction for clones
+        EnvCache(Environment* inputEnvironment, std::shared_ptr<Storage> inputStorage);
+
+        // Member data
+        Environment* dataEnvironment;
+        bool dataOwner;
+        std::shared_ptr<Storage> dataStorage;
+};
+
+
+// Include guard
+#endif
@@ -59,6 +59,13 @@ Client::~Client() {
         delete dataDNA;
 }
 
+// Copy assignment (reuses the storage of the DNA)
+Client& Client::operator= (const Client& inputClient) {
+    *dataDNA = *inputClient.get();
+    dataAlphabet = inputClient.dataAlphabet;
+    return *this;
+}
+
 
 //
 // DNA IO
@@ -68,6 +75,11 @@ const DNA* Client::get() const {
 	return dataDNA;
 }
 
+// Move the DNA out of the client, leaving it empty
+DNA Client::release() {
+	return std::move(*dataDNA);
+}
+
 
 //
 // DNA alteration
@@ -162,8 +174,7 @@ void Client::mutate_point() {
 
     // Generate replacment gen
     unsigned char* replace = (unsigned char*) malloc(window_size * sizeof(unsigned char));
-    for (unsigned int i = 0; i < window_size; i++)
-        replace[i] = (unsigned char) random_int(0, dataAlphabet);
+    random_fill(replace, window_size, 0, dataAlphabet);
 
     // Commit the replacment
     dataDNA->replace(start, replace, window_size);
@@ -64,6 +64,7 @@ class Client
 		Client(const Client& inputClient);
 		Client(const DNA& inputDNA, int inputAlphabet);
                 ~Client();
+                Client& operator= (const Client& inputClient);
 
 		// DNA alteration
 		void mutate();
@@ -72,6 +73,7 @@ class Client
 
 		// DNA output
 		const DNA* get() const;
+		DNA release();
 
 		// Alphabet
 		int dataAlphabet;
@@ -43,34 +43,41 @@
 
 // Copy constructor
 DNA::DNA(const DNA& inputDNA) {
-    dataSize = inputDNA.dataSize;
+    init(inputDNA.dataSize);
 
     // Deep copy of genes
-    dataGenes = (unsigned char*) malloc(dataSize * sizeof(unsigned char));
     std::memcpy(dataGenes, inputDNA.dataGenes, dataSize);
+
+    // Copy the index
+    dataSeparators = inputDNA.dataSeparators;
+    dataIndexed = inputDNA.dataIndexed;
+}
+
+// Move constructor
+DNA::DNA(DNA&& inputDNA) {
+    init(0);
+    *this = std::move(inputDNA);
 }
 
 // Constructor with initializer list
 DNA::DNA(const std::initializer_list<unsigned char> inputList) {
-    dataSize = inputList.size();
+    init(inputList.size());
 
     // Initialize genes
-    dataGenes = (unsigned char*) malloc(dataSize * sizeof(unsigned char));
     std::memcpy(dataGenes, inputList.begin(), dataSize);
 }
 
 // Constructor with parameters
 DNA::DNA(const unsigned char* inputGenes, int inputSize) {
-    dataSize = inputSize;
+    init(inputSize);
 
     // Deep copy of genes
-    dataGenes = (unsigned char*) malloc(inputSize * sizeof(unsigned char));
     std::memcpy(dataGenes, inputGenes, inputSize);
 }
 
 // Destructor
 DNA::~DNA() {
-    if (dataSize > 0)
+    if (dataGenes != dataInline)
         free(dataGenes);
 }
 
@@ -81,22 +88,140 @@ DNA::~DNA() {
 
 // Amount of genes
 unsigned int DNA::genes() const {
-    int genes = 0;
     if (dataSize == 0)
         return 0;
 
-    for (unsigned int i = 0; i < dataSize; i++) {
-        if (dataGenes[i] == 0) {
-            genes++;
-        }
-    }
-    return genes+1;
+    index();
+    return dataSeparators.size()+1;
 }
 unsigned int DNA::length() const
 {
     return dataSize;
 }
 
+// Amount of bytes which can be stored without reallocating
+unsigned int DNA::capacity() const
+{
+    return dataCapacity;
+}
+
+// 64-bit hash of the contents
+uint64_t DNA::hash() const
+{
+    return hash(dataGenes, dataSize);
+}
+
+// 64-bit hash of a byte array
+//   processes 8 bytes at a time, and finishes with the SplitMix64 mixer
+uint64_t DNA::hash(const unsigned char* inputData, unsigned int inputSize)
+{
+    const uint64_t K = 0x9E3779B97F4A7C15ULL;
+    uint64_t h = inputSize * K;
+
+    // Full words
+    unsigned int i = 0;
+    for (; i+8 <= inputSize; i += 8) {
+        uint64_t word;
+        memcpy(&word, &inputData[i], 8);
+        h = (h ^ word) * K;
+        h ^= h >> 29;
+    }
+
+    // Remaining bytes
+    uint64_t tail = 0;
+    for (unsigned int j = 0; i+j < inputSize; j++)
+        tail |= (uint64_t) inputData[i+j] << (8*j);
+    h = (h ^ tail) * K;
+
+    // Finalize
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+
+//
+// Modification tracking
+//
+
+// Offset of the first byte which got modified since the string was
+// constructed or copied, or DNA_UNMODIFIED
+unsigned int DNA::modified() const
+{
+    return dataModified;
+}
+
+// Index of the first gene which might have been modified since the string
+// was constructed or copied (all earlier genes are guaranteed to be
+// unaltered), or the amount of genes
+unsigned int DNA::modified_gene() const
+{
+    if (dataModified == DNA_UNMODIFIED)
+        return genes();
+
+    index();
+    return std::lower_bound(dataSeparators.begin(), dataSeparators.end(), dataModified) - dataSeparators.begin();
+}
+
+// Record a modification starting at a given offset
+void DNA::touch(unsigned int i_start) {
+    dataModified = std::min(dataModified, i_start);
+}
+
+
+//
+// Storage management
+//
+
+// Make room for a given amount of bytes
+void DNA::reserve(unsigned int inputCapacity) {
+    if (inputCapacity <= dataCapacity)
+        return;
+
+    if (dataGenes == dataInline) {
+        dataGenes = (unsigned char*) malloc(inputCapacity * sizeof(unsigned char));
+        std::memcpy(dataGenes, dataInline, dataSize);
+    } else {
+        dataGenes = (unsigned char*) std::realloc(dataGenes, inputCapacity * sizeof(unsigned char));
+    }
+    dataCapacity = inputCapacity;
+}
+
+// Release unused storage
+void DNA::shrink_to_fit() {
+    if (dataGenes == dataInline || dataSize == dataCapacity)
+        return;
+
+    if (dataSize <= DNA_INLINE_SIZE) {
+        std::memcpy(dataInline, dataGenes, dataSize);
+        free(dataGenes);
+        dataGenes = dataInline;
+        dataCapacity = DNA_INLINE_SIZE;
+    } else {
+        dataGenes = (unsigned char*) std::realloc(dataGenes, dataSize * sizeof(unsigned char));
+        dataCapacity = dataSize;
+    }
+    dataSeparators.shrink_to_fit();
+}
+
+// Initialize the storage for a given amount of bytes
+void DNA::init(unsigned int inputSize) {
+    dataGenes = dataInline;
+    dataSize = 0;
+    dataCapacity = DNA_INLINE_SIZE;
+    dataIndexed = false;
+    dataModified = DNA_UNMODIFIED;
+
+    reserve(inputSize);
+    dataSize = inputSize;
+}
+
+// Grow the storage geometrically, to fit a given amount of bytes
+void DNA::grow(unsigned int inputSize) {
+    if (inputSize > dataCapacity)
+        reserve(std::max(inputSize, 2*dataCapacity));
+}
+
 
 //
 // Raw modifiers
@@ -112,9 +237,8 @@ void DNA::erase(unsigned int i_start, unsigned int i_end) {
 
     // Move genes
     memmove(p_start, p_end, dataSize-i_end);
-
-    // Shrink data container
-    dataGenes = (unsigned char*) std::realloc(dataGenes, dataSize-(i_end-i_start) * sizeof(unsigned char));
+    index_erase(i_start, i_end);
+    touch(i_start);
     dataSize -= i_end-i_start;
 }
 
@@ -122,7 +246,7 @@ void DNA::erase(unsigned int i_start, unsigned int i_end) {
 //   inserts data before i_start
 void DNA::insert(unsigned int i_start, unsigned char* gene, unsigned int size) {
     // Enlarge array
-    dataGenes = (unsigned char*) std::realloc(dataGenes, dataSize+size);
+    grow(dataSize+size);
 
     // Get pointers
     assert(i_start < dataSize);
@@ -135,6 +259,8 @@ void DNA::insert(unsigned int i_start, unsigned char* gene, unsigned int size) {
     // Copy new data
     memcpy(p_start, gene, size);
     dataSize += size;
+    index_insert(i_start, gene, size);
+    touch(i_start);
 }
 
 // Replace data
@@ -150,11 +276,11 @@ void DNA::replace(unsigned int i_start, unsigned char* gene, unsigned int size)
 
 // Append data
 void DNA::push_back(unsigned char* gene, unsigned int size) {
-    dataGenes = (unsigned char*) std::realloc(dataGenes, dataSize+size);
-    for (unsigned int i = 0; i < size; i++) {
-        dataGenes[dataSize+i] = gene[i];
-    }
+    grow(dataSize+size);
+    memcpy(&dataGenes[dataSize], gene, size);
     dataSize += size;
+    index_insert(dataSize-size, gene, size);
+    touch(dataSize-size);
 }
 
 // Extract data
@@ -182,9 +308,9 @@ bool DNA::erase_gene(unsigned int index) {
             unsigned int i_next = gene_start(1);
             erase(0, i_next);
         } else {
-            free(dataGenes);
-            dataGenes = 0;
             dataSize = 0;
+            dataIndexed = false;
+            touch(0);
         }
     }
 
@@ -201,8 +327,9 @@ bool DNA::erase_gene(unsigned int index) {
             unsigned int i_prev = gene_end(index-1);
             erase(i_prev, dataSize);
         } else {
-            free(dataGenes);
             dataSize = 0;
+            dataIndexed = false;
+            touch(0);
         }
     }
     return true;
@@ -222,9 +349,11 @@ bool DNA::insert_gene(unsigned int index, unsigned char* gene, unsigned int size
             insert(0, gene_mod, size+1);
             free(gene_mod);
         } else {
-            dataGenes = (unsigned char*) malloc(size * sizeof(unsigned char));
+            grow(size);
             memcpy(dataGenes, gene, size);
             dataSize = size;
+            dataIndexed = false;
+            touch(0);
         }
     }
 
@@ -285,12 +414,126 @@ bool DNA::extract_gene(unsigned int index, unsigned char*& gene, unsigned int& s
     return true;
 }
 
+
+//
+// Gene access
+//
+
+// Get a view on a gene
+Gene DNA::gene(unsigned int index) const {
+    assert(index < genes());
+
+    Gene tempGene;
+    unsigned int i_start = gene_start(index);
+    tempGene.data = dataGenes + i_start;
+    tempGene.size = gene_end(index) - i_start;
+    return tempGene;
+}
+
+// Iterate over all genes
+DNA::const_iterator DNA::begin() const {
+    return const_iterator(this, 0);
+}
+DNA::const_iterator DNA::end() const {
+    return const_iterator(this, genes());
+}
+
+//
+// Serialisation
+//
+
+// Append the serialised string to a buffer
+void DNA::serialize(std::vector<unsigned char>& outputData) const {
+    uint64_t tempHash = hash();
+    for (unsigned int i = 0; i < 4; i++)
+        outputData.push_back((dataSize >> (8*i)) & 0xFF);
+    outputData.insert(outputData.end(), dataGenes, dataGenes + dataSize);
+    for (unsigned int i = 0; i < 8; i++)
+        outputData.push_back((tempHash >> (8*i)) & 0xFF);
+}
+
+// Replace the contents by a serialised string
+//   returns the amount of bytes used, 0 if the buffer doesn't hold the
+//   entire string yet, or -1 if it is invalid (too long, or not matching
+//   its hash); the string only gets modified on success
+int DNA::deserialize(const unsigned char* inputData, unsigned int inputSize) {
+    if (inputSize < 4)
+        return 0;
+    unsigned int tempSize = 0;
+    for (unsigned int i = 0; i < 4; i++)
+        tempSize |= (unsigned int) inputData[i] << (8*i);
+    if (tempSize > DNA_SERIAL_MAXIMUM)
+        return -1;
+    if (inputSize < tempSize + DNA_SERIAL_OVERHEAD)
+        return 0;
+
+    uint64_t tempHash = 0;
+    for (unsigned int i = 0; i < 8; i++)
+        tempHash |= (uint64_t) inputData[4+tempSize+i] << (8*i);
+    if (tempHash != hash(inputData + 4, tempSize))
+        return -1;
+
+    grow(tempSize);
+    std::memcpy(dataGenes, inputData + 4, tempSize);
+    dataSize = tempSize;
+    dataSeparators.clear();
+    dataIndexed = false;
+    touch(0);
+    return tempSize + DNA_SERIAL_OVERHEAD;
+}
+
+
 //
 // Operators
 //
 
+// Copy assignment
+//   reuses the existing storage if it is large enough, and starts tracking
+//   modifications anew
+DNA& DNA::operator= (const DNA& dna) {
+    if (this == &dna)
+        return *this;
+
+    grow(dna.dataSize);
+    std::memcpy(dataGenes, dna.dataGenes, dna.dataSize);
+    dataSize = dna.dataSize;
+    dataSeparators = dna.dataSeparators;
+    dataIndexed = dna.dataIndexed;
+    dataModified = DNA_UNMODIFIED;
+    return *this;
+}
+
+// Move assignment
+//   takes over heap storage, inline storage gets copied; unlike a copy, the
+//   modification offset is taken over as well
+DNA& DNA::operator= (DNA&& dna) {
+    if (this == &dna)
+        return *this;
+
+    if (dna.dataGenes == dna.dataInline) {
+        *this = static_cast<const DNA&>(dna);
+    } else {
+        if (dataGenes != dataInline)
+            free(dataGenes);
+        dataGenes = dna.dataGenes;
+        dataSize = dna.dataSize;
+        dataCapacity = dna.dataCapacity;
+        dataSeparators.swap(dna.dataSeparators);
+        dataIndexed = dna.dataIndexed;
+
+        // Leave the other string empty
+        dna.dataGenes = dna.dataInline;
+        dna.dataCapacity = DNA_INLINE_SIZE;
+    }
+    dataModified = dna.dataModified;
+    dna.dataSize = 0;
+    dna.dataIndexed = false;
+    dna.touch(0);
+    return *this;
+}
+
 // Comparison
-bool DNA::operator== (const DNA& dna) {
+bool DNA::operator== (const DNA& dna) const {
     if (dataSize != dna.dataSize)
         return false;
 
@@ -301,7 +544,7 @@ bool DNA::operator== (const DNA& dna) {
 
     return true;
 }
-bool DNA::operator!= (const DNA& dna) {
+bool DNA::operator!= (const DNA& dna) const {
     return !(*this == dna);
 }
 
@@ -353,15 +596,10 @@ void DNA::debug_raw() const {
 
 // Find the location of a separator
 unsigned int DNA::separator(unsigned int index) const {
-    unsigned int sep = 0;
-    for (unsigned int i = 0; i < dataSize; i++) {
-        if (dataGenes[i] == 0) {
-            if (++sep == index) {
-                return i;
-            }
-        }
-    }
-    return 0;
+    this->index();
+    if (index == 0 || index > dataSeparators.size())
+        return 0;
+    return dataSeparators[index-1];
 }
 
 // Returns the index of the first data part of a gene (inclusive)
@@ -379,4 +617,56 @@ unsigned int DNA::gene_end(unsigned int index) const {
         return separator(index+1);
     else
         return dataSize;
-}
\ No newline at end of file
+}
+
+
+//
+// Gene index
+//
+
+// Build the separator index, if needed
+void DNA::index() const {
+    if (dataIndexed)
+        return;
+
+    dataSeparators.clear();
+    for (unsigned int i = 0; i < dataSize; i++) {
+        if (dataGenes[i] == 0)
+            dataSeparators.push_back(i);
+    }
+    dataIndexed = true;
+}
+
+// Update the index after data got inserted before i_start
+void DNA::index_insert(unsigned int i_start, const unsigned char* gene, unsigned int size) {
+    if (!dataIndexed)
+        return;
+
+    // Move the separators after the insertion point
+    std::vector<unsigned int>::iterator it = std::lower_bound(dataSeparators.begin(), dataSeparators.end(), i_start);
+    for (std::vector<unsigned int>::iterator it2 = it; it2 != dataSeparators.end(); it2++)
+        *it2 += size;
+
+    // Add the new separators
+    std::vector<unsigned int> inserted;
+    for (unsigned int i = 0; i < size; i++) {
+        if (gene[i] == 0)
+            inserted.push_back(i_start+i);
+    }
+    dataSeparators.insert(it, inserted.begin(), inserted.end());
+}
+
+// Update the index after data from i_start (inclusive) to i_end (exclusive) got erased
+void DNA::index_erase(unsigned int i_start, unsigned int i_end) {
+    if (!dataIndexed)
+        return;
+
+    // Remove the erased separators
+    std::vector<unsigned int>::iterator it_start = std::lower_bound(dataSeparators.begin(), dataSeparators.end(), i_start);
+    std::vector<unsigned int>::iterator it_end = std::lower_bound(it_start, dataSeparators.end(), i_end);
+    std::vector<unsigned int>::iterator it = dataSeparators.erase(it_start, it_end);
+
+    // Move the separators after the erased region
+    for (; it != dataSeparators.end(); it++)
+        *it -= i_end-i_start;
+}
@@ -38,13 +38,49 @@
 #include <cstring>
 #include <cstdlib>
 #include <assert.h>
+#include <stdint.h>
 #include <initializer_list>
+#include <vector>
+#include <algorithm>
+#include <utility>
 
 
 //
 // Constants
 //
 
+// Amount of bytes stored inline, before the heap gets used
+//   the default fits parser programs (e.g. tetris) without making every
+//   string much larger; image genomes take up to some 750 bytes (50 polygons
+//   of at most 5 points), so builds evolving those can raise DNA_INLINE in
+//   the top-level CMakeLists.txt (e.g. to 768)
+#ifdef DNA_INLINE
+const unsigned int DNA_INLINE_SIZE = DNA_INLINE;
+#else
+const unsigned int DNA_INLINE_SIZE = 64;
+#endif
+
+// Modification offset of a string which hasn't been modified
+const unsigned int DNA_UNMODIFIED = (unsigned int) -1;
+
+// Serialised strings: a 32-bit length, the contents, and a 64-bit hash of
+// the contents (all integers little-endian); longer strings are rejected
+const unsigned int DNA_SERIAL_OVERHEAD = 12;
+const unsigned int DNA_SERIAL_MAXIMUM = 1 << 24;
+
+
+
+//
+// Auxiliary structures
+//
+
+// Non-owning view on a gene
+//   points into the storage of the DNA, and is invalidated by any modification
+struct Gene {
+    const unsigned char* data;
+    unsigned int size;
+};
+
 
 //////////////////////
 // CLASS DEFINITION //
@@ -55,6 +91,7 @@ class DNA
 	public:
 		// Construction and destruction
 		DNA(const DNA& inputData);
+		DNA(DNA&& inputData);
 		DNA(const std::initializer_list<unsigned char>);
                 DNA(const unsigned char* inputData, int inputSize);
                 ~DNA();
@@ -62,6 +99,17 @@ class DNA
 		// Informational routines
 		unsigned int genes() const;
 		unsigned int length() const;
+		unsigned int capacity() const;
+		uint64_t hash() const;
+		static uint64_t hash(const unsigned char* inputData, unsigned int inputSize);
+
+                // Modification tracking
+                unsigned int modified() const;
+                unsigned int modified_gene() const;
+
+                // Storage management
+                void reserve(unsigned int inputCapacity);
+                void shrink_to_fit();
 
                 // Raw modifiers
                 void erase(unsigned int i_start, unsigned int i_end);
@@ -77,9 +125,21 @@ class DNA
                 bool push_back_gene(unsigned char* item, unsigned int size);
                 bool extract_gene(unsigned int index, unsigned char*& gene, unsigned int& size) const;
 
+                // Gene access
+                class const_iterator;
+                Gene gene(unsigned int index) const;
+                const_iterator begin() const;
+                const_iterator end() const;
+
+                // Serialisation
+                void serialize(std::vector<unsigned char>& outputData) const;
+                int deserialize(const unsigned char* inputData, unsigned int inputSize);
+
                 // Operators
-                bool operator== (const DNA& dna);
-                bool operator!= (const DNA& dna);
+                DNA& operator= (const DNA& dna);
+                DNA& operator= (DNA&& dna);
+                bool operator== (const DNA& dna) const;
+                bool operator!= (const DNA& dna) const;
 
 		// Debugging routines
 		void debug() const;
@@ -91,9 +151,51 @@ class DNA
                 unsigned int gene_end(unsigned int index) const;
 
 	private:
+                // Storage management
+                void init(unsigned int inputSize);
+                void grow(unsigned int inputSize);
+
+                // Modification tracking
+                void touch(unsigned int i_start);
+
+                // Gene index
+                void index() const;
+                void index_insert(unsigned int i_start, const unsigned char* gene, unsigned int size);
+                void index_erase(unsigned int i_start, unsigned int i_end);
+
                 // Member data
 		unsigned char* dataGenes;
-                unsigned int dataSize;
+                unsigned int dataSize, dataCapacity;
+
+                // Inline storage for short strings
+                unsigned char dataInline[DNA_INLINE_SIZE];
+
+                // Separator locations (built lazily, and updated by the raw modifiers)
+                mutable std::vector<unsigned int> dataSeparators;
+                mutable bool dataIndexed;
+
+                // Lowest offset modified since construction or the last copy
+                unsigned int dataModified;
+};
+
+
+
+// Iterator over the genes of a DNA string
+class DNA::const_iterator
+{
+	public:
+		// Construction and destruction
+		const_iterator(const DNA* inputDNA, unsigned int inputIndex) : dataDNA(inputDNA), dataIndex(inputIndex) {}
+
+		// Operators
+		Gene operator* () const { return dataDNA->gene(dataIndex); }
+		const_iterator& operator++ () { dataIndex++; return *this; }
+		bool operator== (const const_iterator& it) const { return dataIndex == it.dataIndex; }
+		bool operator!= (const const_iterator& it) const { return dataIndex != it.dataIndex; }
+
+	private:
+		const DNA* dataDNA;
+		unsigned int dataIndex;
 };
 
 
@@ -37,4 +37,36 @@
 // CLASS ROUTINES //
 ////////////////////
 
-/* None at the moment */
+//
+// Construction and destruction
+//
+
+// Destructor
+Environment::~Environment() {
+}
+
+
+//
+// Required functions
+//
+
+// Batched fitness function
+//   calculates the fitness of several DNA strings at once; environments
+//   can override this to share setup costs between evaluations
+void Environment::fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize) {
+    for (unsigned int i = 0; i < inputSize; i++)
+        outputFitness[i] = fitness(inputDNA[i]);
+}
+
+
+//
+// Parallel evaluation
+//
+
+// Create an independent copy of the environment
+//   every evaluation worker owns a copy, so fitness() can be called
+//   concurrently; environments which cannot be copied return 0, and
+//   will be evaluated serially
+Environment* Environment::clone() const {
+    return 0;
+}
@@ -44,12 +44,19 @@
 class Environment
 {
 	public:
+		// Construction and destruction
+		virtual ~Environment();
+
 		// Required functions
 		virtual double fitness(const DNA* inputDNA) = 0;
+		virtual void fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize);
 		virtual int alphabet() const = 0;
 		virtual void update(const DNA* inputDNA) = 0;
 		virtual bool condition() = 0;
 
+		// Thread-safe copy for parallel evaluation (0 if unsupported)
+		virtual Environment* clone() const;
+
                 // TODO: explain function
 };
 
@@ -0,0 +1,295 @@
+/*
+ * comparison.cpp
+ * Evolve - Image generating environment (comparison strategy)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "comparison.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Construction & destruction
+//
+
+// Constructor
+Comparison::Comparison(COMPARISON inputMethod, int inputColumns, int inputRows)
+{
+    dataMethod = inputMethod;
+    dataColumns = std::max(inputColumns, 1);
+    dataRows = std::max(inputRows, 1);
+    dataWeights[0] = dataWeights[1] = dataWeights[2] = 1;
+    dataThreshold = PYRAMID_THRESHOLD;
+
+    dataWidth = 0;
+    dataHeight = 0;
+}
+
+
+//
+// Configuration
+//
+
+// Set the comparison method
+void Comparison::setMethod(COMPARISON inputMethod) {
+    dataMethod = inputMethod;
+}
+
+// Get the comparison method
+COMPARISON Comparison::getMethod() const {
+    return dataMethod;
+}
+
+// Set the block grid of the averaging method (which gets limited to one
+// block per pixel)
+void Comparison::setGrid(int inputColumns, int inputRows) {
+    dataColumns = std::max(inputColumns, 1);
+    dataRows = std::max(inputRows, 1);
+    if (dataTarget)
+        help_grid();
+}
+
+// Get the block grid of the averaging method
+int Comparison::getColumns() const {
+    return dataColumns;
+}
+int Comparison::getRows() const {
+    return dataRows;
+}
+
+// Set the channel weights of the averaging method (negative weights count
+// as zero)
+void Comparison::setWeights(int inputRed, int inputGreen, int inputBlue) {
+    dataWeights[0] = std::max(inputBlue, 0);
+    dataWeights[1] = std::max(inputGreen, 0);
+    dataWeights[2] = std::max(inputRed, 0);
+}
+
+// Get the channel weights of the averaging method
+void Comparison::getWeights(int& outputRed, int& outputGreen, int& outputBlue) const {
+    outputRed = dataWeights[2];
+    outputGreen = dataWeights[1];
+    outputBlue = dataWeights[0];
+}
+
+// Set the threshold of the pyramid method
+void Comparison::setThreshold(double inputThreshold) {
+    dataThreshold = inputThreshold;
+}
+
+// Get the threshold of the pyramid method
+double Comparison::getThreshold() const {
+    return dataThreshold;
+}
+
+
+//
+// Input image
+//
+
+// Set the input image (RGB24 data, without padding)
+void Comparison::setup(const unsigned char* inputData, int inputWidth, int inputHeight) {
+    dataWidth = inputWidth;
+    dataHeight = inputHeight;
+    dataTarget.reset(new std::vector<unsigned char>(inputData, inputData + 4*inputWidth*inputHeight));
+
+    // Calculate the integral image, row by row
+    std::vector<unsigned int>* tempIntegral = new std::vector<unsigned int>(3*(inputWidth+1)*(inputHeight+1), 0);
+    for (int y = 0; y < inputHeight; y++) {
+        unsigned int tempRow[3] = {0, 0, 0};
+        unsigned int* tempAbove = &(*tempIntegral)[3*y*(inputWidth+1)];
+        unsigned int* tempCurrent = tempAbove + 3*(inputWidth+1);
+        for (int x = 0; x < inputWidth; x++) {
+            for (int c = 0; c < 3; c++) {
+                tempRow[c] += inputData[4*(y*inputWidth + x) + c];
+                tempCurrent[3*(x+1) + c] = tempAbove[3*(x+1) + c] + tempRow[c];
+            }
+        }
+    }
+    dataIntegral.reset(tempIntegral);
+
+    help_grid();
+}
+
+// Get the input image
+const unsigned char* Comparison::target() const {
+    return dataTarget ? &(*dataTarget)[0] : 0;
+}
+
+
+//
+// Comparison of an entire image
+//
+
+// Difference between an image and the input image
+long Comparison::difference(const unsigned char* inputData) const {
+    switch (dataMethod) {
+        case COMPARISON_AVERAGE:
+        {
+            // Sum and compare one block at a time (which needs no storage
+            // for the sums of the other blocks)
+            int tempColumns = dataBoundsX.size() - 1, tempRows = dataBoundsY.size() - 1;
+            long difference = 0;
+            for (int r = 0; r < tempRows; r++) {
+                for (int c = 0; c < tempColumns; c++) {
+                    region tempBlock = block(c, r);
+                    long tempSums[3] = {0, 0, 0};
+                    kernel_sum(inputData + 4*(tempBlock.top*dataWidth + tempBlock.left), tempBlock.right - tempBlock.left, tempBlock.bottom - tempBlock.top, 4*dataWidth, tempSums);
+                    difference += block_difference(r*tempColumns + c, tempSums);
+                }
+            }
+            return difference;
+        }
+        default:
+        {
+            region tempRegion = {0, 0, dataWidth, dataHeight};
+            return difference_nmse(inputData, tempRegion);
+        }
+    }
+}
+
+// Similarity for a given total difference
+double Comparison::similarity(long inputDifference) const {
+    switch (dataMethod) {
+        case COMPARISON_AVERAGE:
+        {
+            long tempWeight = dataWeights[0] + dataWeights[1] + dataWeights[2];
+            if (tempWeight == 0)
+                return 1.0;
+            return 1.0 - ((double) inputDifference / (255.0 * blocks() * tempWeight));
+        }
+        default:
+            return 1.0 - ((double) inputDifference / (sqrt(3.0*255.0*255.0) * dataWidth * dataHeight));
+    }
+}
+
+
+//
+// Normalised Mean Square Error method
+//
+
+// Difference with the input image within a region
+long Comparison::difference_nmse(const unsigned char* inputData, const region& inputRegion) const {
+    const unsigned char* tempTarget = target();
+    long difference = 0;
+    for (int y = inputRegion.top; y < inputRegion.bottom; y++) {
+        int tempOffset = 4*(y*dataWidth + inputRegion.left);
+        difference += kernel_distance(tempTarget + tempOffset, inputData + tempOffset, inputRegion.right - inputRegion.left);
+    }
+    return difference;
+}
+
+
+//
+// Averaging method
+//
+
+// Amount of blocks
+int Comparison::blocks() const {
+    if (dataBoundsX.empty() || dataBoundsY.empty())
+        return 0;
+    return (dataBoundsX.size() - 1) * (dataBoundsY.size() - 1);
+}
+
+// Column of the blocks covering a horizontal coordinate
+int Comparison::column(int inputX) const {
+    return std::upper_bound(dataBoundsX.begin(), dataBoundsX.end(), inputX) - dataBoundsX.begin() - 1;
+}
+
+// Row of the blocks covering a vertical coordinate
+int Comparison::row(int inputY) const {
+    return std::upper_bound(dataBoundsY.begin(), dataBoundsY.end(), inputY) - dataBoundsY.begin() - 1;
+}
+
+// Bounds of a block
+region Comparison::block(int inputColumn, int inputRow) const {
+    region tempBlock = {dataBoundsX[inputColumn], dataBoundsY[inputRow], dataBoundsX[inputColumn+1], dataBoundsY[inputRow+1]};
+    return tempBlock;
+}
+
+// Calculate the channel sums of all blocks of an image (3 per block, row by
+// row)
+void Comparison::block_sums(const unsigned char* inputData, long* outputSums) const {
+    int tempColumns = dataBoundsX.size() - 1, tempRows = dataBoundsY.size() - 1;
+    std::fill(outputSums, outputSums + 3*tempColumns*tempRows, 0);
+    for (int r = 0; r < tempRows; r++) {
+        for (int c = 0; c < tempColumns; c++) {
+            region tempBlock = block(c, r);
+            kernel_sum(inputData + 4*(tempBlock.top*dataWidth + tempBlock.left), tempBlock.right - tempBlock.left, tempBlock.bottom - tempBlock.top, 4*dataWidth, outputSums + 3*(r*tempColumns + c));
+        }
+    }
+}
+
+// Difference of a block, given its channel sums
+long Comparison::block_difference(int inputBlock, const long* inputSums) const {
+    int tempColumns = dataBoundsX.size() - 1;
+    int c = inputBlock % tempColumns, r = inputBlock / tempColumns;
+    long tempCount = (long) (dataBoundsX[c+1] - dataBoundsX[c]) * (dataBoundsY[r+1] - dataBoundsY[r]);
+
+    long difference = 0;
+    for (int i = 0; i < 3; i++)
+        difference += dataWeights[i] * std::abs(dataAverages[3*inputBlock+i] - (int) (inputSums[i] / tempCount));
+    return difference;
+}
+
+// Calculate the block bounds, and the average channels of the input image
+// per block
+void Comparison::help_grid() {
+    int tempColumns = std::min(dataColumns, std::max(dataWidth, 1));
+    int tempRows = std::min(dataRows, std::max(dataHeight, 1));
+    dataBoundsX.resize(tempColumns+1);
+    for (int c = 0; c <= tempColumns; c++)
+        dataBoundsX[c] = (long) c * dataWidth / tempColumns;
+    dataBoundsY.resize(tempRows+1);
+    for (int r = 0; r <= tempRows; r++)
+        dataBoundsY[r] = (long) r * dataHeight / tempRows;
+
+    // Sum every block from the corners of the integral image
+    const std::vector<unsigned int>& tempIntegral = *dataIntegral;
+    dataAverages.resize(3*tempColumns*tempRows);
+    for (int r = 0; r < tempRows; r++) {
+        for (int c = 0; c < tempColumns; c++) {
+            region tempBlock = block(c, r);
+            long tempCount = (long) (tempBlock.right - tempBlock.left) * (tempBlock.bottom - tempBlock.top);
+            for (int i = 0; i < 3; i++) {
+                unsigned int tempSum = tempIntegral[3*(tempBlock.bottom*(dataWidth+1) + tempBlock.right) + i]
+                                     - tempIntegral[3*(tempBlock.top*(dataWidth+1) + tempBlock.right) + i]
+                                     - tempIntegral[3*(tempBlock.bottom*(dataWidth+1) + tempBlock.left) + i]
+                                     + tempIntegral[3*(tempBlock.top*(dataWidth+1) + tempBlock.left) + i];
+                dataAverages[3*(r*tempColumns + c) + i] = tempSum / tempCount;
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * comparison.h
+ * Evolve - Image generating environment (comparison strategy)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __COMPARISON
+#define __COMPARISON
+
+// Headers
+#include "raster.h"
+#include "kernels.h"
+#include <vector>
+#include <memory>
+
+
+//
+// Constants
+//
+
+// Comparison methods
+enum COMPARISON {
+    COMPARISON_NMSE,        // Normalised Mean Square Error
+    COMPARISON_AVERAGE,     // difference of the average colours of a grid of blocks
+    COMPARISON_PYRAMID      // NMSE, after screening at lower resolutions
+};
+
+// Default comparison method
+const COMPARISON COMPARISON_METHOD = COMPARISON_AVERAGE;
+
+// Default block grid of the averaging method
+const int AVERAGE_DIV_X = 32;
+const int AVERAGE_DIV_Y = 32;
+
+// Default threshold of the pyramid method: how much worse than the best
+// string a string may score at a lower resolution before it gets rejected
+const double PYRAMID_THRESHOLD = 0.002;
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Comparison strategy
+//   configures how rendered images get compared against the input image,
+//   and holds the data of that image needed to do so. An integral image of
+//   the input makes the block averages of any grid available in a time
+//   proportional to the amount of blocks. Blocks are bounded at multiples
+//   of width/columns and height/rows (rounded down), so that they cover
+//   every pixel, and the difference of a block is the weighted sum of the
+//   absolute differences of its average channels.
+class Comparison
+{
+    public:
+        // Construction & destruction
+        Comparison(COMPARISON inputMethod = COMPARISON_METHOD, int inputColumns = AVERAGE_DIV_X, int inputRows = AVERAGE_DIV_Y);
+
+        // Configuration
+        void setMethod(COMPARISON inputMethod);
+        COMPARISON getMethod() const;
+        void setGrid(int inputColumns, int inputRows);
+        int getColumns() const;
+        int getRows() const;
+        void setWeights(int inputRed, int inputGreen, int inputBlue);
+        void getWeights(int& outputRed, int& outputGreen, int& outputBlue) const;
+        void setThreshold(double inputThreshold);
+        double getThreshold() const;
+
+        // Input image
+        void setup(const unsigned char* inputData, int inputWidth, int inputHeight);
+        const unsigned char* target() const;
+
+        // Comparison of an entire image
+        long difference(const unsigned char* inputData) const;
+        double similarity(long inputDifference) const;
+
+        // Normalised Mean Square Error method
+        long difference_nmse(const unsigned char* inputData, const region& inputRegion) const;
+
+        // Averaging method
+        int blocks() const;
+        int column(int inputX) const;
+        int row(int inputY) const;
+        region block(int inputColumn, int inputRow) const;
+        void block_sums(const unsigned char* inputData, long* outputSums) const;
+        long block_difference(int inputBlock, const long* inputSums) const;
+
+    private:
+        // Grid helper functions
+        void help_grid();
+
+        // Configuration
+        COMPARISON dataMethod;
+        int dataColumns, dataRows;
+        int dataWeights[3];         // in memory order (blue, green, red)
+        double dataThreshold;
+
+        // Input image, and its integral image: the channel sums of all
+        // pixels above and left of every point (modulo 2^32, which keeps
+        // the sums of blocks below that size exact); both are immutable,
+        // and shared between copies
+        int dataWidth, dataHeight;
+        std::shared_ptr<const std::vector<unsigned char> > dataTarget;
+        std::shared_ptr<const std::vector<unsigned int> > dataIntegral;
+
+        // Block grid: boundaries, and the average channels of the input
+        std::vector<int> dataBoundsX, dataBoundsY;
+        std::vector<int> dataAverages;
+};
+
+
+// Include guard
+#endif
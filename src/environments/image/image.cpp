@@ -44,19 +44,59 @@
 // Constructor
 EnvImage::EnvImage()
 {
-    // Reset comparison data
-    data_nmse = NULL;
-    data_average = NULL;
+    // Reset the scratch surface
+    dataSurface = NULL;
+    dataContext = NULL;
+
+    // Default rendering backend
+    dataRenderer = IMAGE_RENDERER;
+
+    // Empty render cache
+    dataReference = NULL;
+    dataLayerCount = 0;
+    dataIncremental = IMAGE_INCREMENTAL;
+}
+
+// Constructor, with a given comparison strategy
+EnvImage::EnvImage(const Comparison& inputComparison) : EnvImage()
+{
+    dataComparison = inputComparison;
+}
+
+// Copy constructor
+EnvImage::EnvImage(const EnvImage& inputEnvironment)
+{
+    dataInputFile = inputEnvironment.dataInputFile;
+    dataInputWidth = inputEnvironment.dataInputWidth;
+    dataInputHeight = inputEnvironment.dataInputHeight;
+
+    // Copy of the comparison data (which shares the input image)
+    dataComparison = inputEnvironment.dataComparison;
+    dataPyramid = inputEnvironment.dataPyramid;
+
+    // The scratch surface is not shared
+    dataSurface = NULL;
+    dataContext = NULL;
+
+    dataRenderer = inputEnvironment.dataRenderer;
+
+    // The render cache is not shared either
+    dataReference = NULL;
+    dataLayerCount = 0;
+    dataIncremental = inputEnvironment.dataIncremental;
 }
 
 // Destructor
 EnvImage::~EnvImage()
 {
-    // Delete comparison data
-    if (data_nmse != NULL)
-        delete[] data_nmse;
-    if (data_average != NULL)
-        delete[] data_average;
+    // Delete the scratch surface
+    if (dataContext != NULL)
+        cairo_destroy(dataContext);
+    if (dataSurface != NULL)
+        cairo_surface_destroy(dataSurface);
+
+    // Delete the render cache
+    cache_clear();
 }
 
 
@@ -66,23 +106,61 @@ EnvImage::~EnvImage()
 
 // Fitness function
 double EnvImage::fitness(const DNA* inputDNA) {
-    // Check amount of polygons
-    unsigned int genes = inputDNA->genes();
-    if (genes < 1 || genes > LIMIT_POLYGONS)
-            return 0;   // TODO: define 0 or -1 as invalid
+    double resemblance;
+    fitness(&inputDNA, &resemblance, 1);
+    return resemblance;
+}
 
-    // Create a DC for the generated image
-    cairo_surface_t* tempSurface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, dataInputWidth, dataInputHeight);
+// Batched fitness function
+//   all DNA strings get drawn onto the same scratch surface, starting from
+//   the deepest cached layer they share with the best string so far
+void EnvImage::fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize) {
+    cairo_surface_t* tempSurface = scratch();
+    unsigned char* tempData = cairo_image_surface_get_data(tempSurface);
+    int tempSize = cairo_image_surface_get_stride(tempSurface) * dataInputHeight;
+
+    for (unsigned int i = 0; i < inputSize; i++) {
+        // Check amount of polygons
+        unsigned int genes = inputDNA[i]->genes();
+        if (genes < 1 || genes > LIMIT_POLYGONS) {
+            outputFitness[i] = 0;   // TODO: define 0 or -1 as invalid
+            continue;
+        }
 
-    // Draw the DNA onto the DC
-    draw(tempSurface, inputDNA);
+        // Find the cached layers to start from
+        unsigned int tempPrefix = cache_prefix(inputDNA[i]);
+        unsigned int tempLayers = std::min(tempPrefix / IMAGE_LAYER_INTERVAL, dataLayerCount);
 
-    // Compare them
-    double resemblance = compare(tempSurface);
+        // Reject strings which already score badly at lower resolutions
+        if (dataComparison.getMethod() == COMPARISON_PYRAMID && dataReference != NULL && !pyramid_screen(inputDNA[i], tempLayers, outputFitness[i]))
+            continue;
 
-    // Finish
-    cairo_surface_destroy(tempSurface);
-    return resemblance;
+        // Only evaluate the region which differs from the best string
+        if (dataIncremental && dataReference != NULL) {
+            outputFitness[i] = fitness_region(inputDNA[i], tempPrefix, tempLayers);
+        }
+
+        // Evaluate the entire image
+        else {
+            // Start from a cached layer, or clear the surface to white (both
+            // without a round trip through Cairo)
+            cairo_surface_flush(tempSurface);
+            if (tempLayers > 0)
+                std::memcpy(tempData, &dataLayers[(tempLayers-1)*tempSize], tempSize);
+            else
+                std::memset(tempData, 0xFF, tempSize);
+
+            // Draw the remaining genes onto the surface
+            help_render(inputDNA[i], tempLayers*IMAGE_LAYER_INTERVAL, genes);
+
+            // Compare them
+            outputFitness[i] = compare(tempSurface);
+        }
+
+        // Cache the layers of a new best string
+        if (dataReference == NULL || outputFitness[i] > dataReferenceFitness)
+            cache_store(inputDNA[i], outputFitness[i], tempLayers);
+    }
 }
 
 // Alphabet (maximal amount of instructions)
@@ -114,7 +192,15 @@ bool EnvImage::load(std::string inputFile)
 	    return false;
 	}
 
-	// Save size
+	// Save size (which invalidates the render cache, and the scratch surface
+	// which scratch() will recreate at the new size)
+	cache_clear();
+	if (dataContext != NULL)
+	    cairo_destroy(dataContext);
+	if (dataSurface != NULL)
+	    cairo_surface_destroy(dataSurface);
+	dataSurface = NULL;
+	dataContext = NULL;
 	dataInputWidth = cairo_image_surface_get_width(tempSurface);
 	dataInputHeight = cairo_image_surface_get_height(tempSurface);
 
@@ -138,88 +224,38 @@ void EnvImage::draw(cairo_surface_t* inputSurface, const DNA* inputDNA) const {
     cairo_rectangle(cr, 0, 0, dataInputWidth, dataInputHeight);
     cairo_fill(cr);
 
-    // Loop all genes
-    unsigned int genes = inputDNA->genes();
-    for (unsigned int gene = 0; gene < genes; gene++) {
-        // Get gene
-        unsigned int size; unsigned char* data;
-        inputDNA->extract_gene(gene, data, size);
-        unsigned char* gene_ptr = data;
-        unsigned int gene_loc = 0;
-
-        // Draw if we have a colour code and at least three points
-        // Also, discard genes with too many points
-        if (size >= 10 && (size-4)/2 < LIMIT_POLYGON_POINTS) {
-            // Get colour code
-            int r = *(gene_ptr++), g = *(gene_ptr++), b = *(gene_ptr++), a = *(gene_ptr++);
-            gene_loc += 4;
-            cairo_set_source_rgba(cr, (r - 1) / 253.0, (g - 1) / 253.0, (b - 1) / 253.0, (a - 1) / 253.0);
-
-            // Save all points in a container
-            std::vector<vertex> points;
-            int x, y;
-            while (gene_loc+1 < size) {
-                // Points vary between 1 and 254, so let 1 be the lower bound and 254 the upper one
-                x = *(gene_ptr++) - 1;
-                y = *(gene_ptr++) - 1;
-                int size = points.size();
-                points.resize(size+1);
-                points[size].x = dataInputWidth * x / 253.0;
-                points[size].y = dataInputHeight * y / 253.0;
-                gene_loc += 2;
-            }
-
-            // Sort the points to avoid complex polygons
-            // http://www.computational-geometry.org/mailing-lists/compgeom-announce/2003-March/000731.html
-            const int points_count = points.size();
-            int start = 0;	// upper left point is starting point
-            for (int i = 0; i < points_count; i++) {
-                if (points[i].y > points[start].y)
-                    start = i;
-                else if (points[i].y == points[start].y && points[i].x < points[start].x)
-                    start = i;
-            }
-            cairo_move_to(cr, points[start].x, points[start].y);
-            points[start].drawn = true;
-            for (int i = 0; i < points_count; i++) {    // calculate angle for each point against startpoint
-                if (i == start)
-                    continue;
-                points[i].angle =  atan2(points[i].y - points[start].y, points[i].x - points[start].x);
-            }
-            for (int i = 0; i < points_count; i++) {    // draw points based on increasing angle
-                double angle;
-                int next = -1;
-                for (int j = 0; j < points_count; j++) {
-                    if (points[j].drawn) {
-                        continue;
-                    }
-                    if (next == -1) {
-                        next = j;
-                        angle = points[j].angle;
-                    } else {
-                        if (points[j].angle < angle) {
-                            angle = points[j].angle;
-                            next = j;
-                        }
-                    }
-                }
-                if (next == -1) {
-                    continue;
-                } else {
-                    cairo_line_to(cr, points[next].x, points[next].y);
-                    points[next].drawn = true;
-                }
-            }
+    // Draw the polygons
+    draw(cr, inputDNA);
+    cairo_destroy(cr);
+}
 
-            // Draw
-            cairo_close_path(cr);
-            cairo_fill(cr);
-        }
+// Render (a range of the genes of) the DNA code onto an existing context,
+// on top of its contents
+void EnvImage::draw(cairo_t* cr, const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast) const {
+    vertex points[LIMIT_POLYGON_POINTS];
+    int colour[4];
 
-        // Clean
-        free(data);
+    // Loop all genes
+    inputLast = std::min(inputLast, inputDNA->genes());
+    for (DNA::const_iterator it(inputDNA, inputFirst), end(inputDNA, std::max(inputFirst, inputLast)); it != end; ++it) {
+        unsigned int points_count = help_polygon(*it, points, colour);
+        if (points_count == 0)
+            continue;
+
+        // Trace and fill the polygon
+        cairo_set_source_rgba(cr, (colour[0] - 1) / 253.0, (colour[1] - 1) / 253.0, (colour[2] - 1) / 253.0, (colour[3] - 1) / 253.0);
+        cairo_move_to(cr, points[0].x, points[0].y);
+        for (unsigned int i = 1; i < points_count; i++)
+            cairo_line_to(cr, points[i].x, points[i].y);
+        cairo_close_path(cr);
+        cairo_fill(cr);
     }
-    cairo_destroy(cr);
+}
+
+// Render (a range of the genes of) the DNA code with the native rasteriser,
+// on top of its contents
+void EnvImage::draw(Raster& inputRaster, const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast) const {
+    help_draw(inputRaster, inputDNA, inputFirst, inputLast, dataInputWidth, dataInputHeight);
 }
 
 // Explain a given DNA set
@@ -235,9 +271,9 @@ void EnvImage::explain(const DNA* inputDNA) const {
     unsigned int genes = inputDNA->genes();
     for (unsigned int gene = 0; gene < genes; gene++) {
         // Get gene
-        unsigned int size; unsigned char* data;
-        inputDNA->extract_gene(gene, data, size);
-        unsigned char* gene_ptr = data;
+        Gene data = inputDNA->gene(gene);
+        unsigned int size = data.size;
+        const unsigned char* gene_ptr = data.data;
         unsigned int gene_loc = 0;
 
         // Get polygon name
@@ -280,78 +316,219 @@ void EnvImage::explain(const DNA* inputDNA) const {
         std::cout << " with colour (" << r << ", " << g << ", " << b << ") % " << a << std::endl;
 
         // TODO: do something with points?
-
-        // Advance
-        free(data);
     }
 }
 
+// Set the rendering backend
+void EnvImage::setRenderer(RENDERER inputRenderer) {
+    dataRenderer = inputRenderer;
+    cache_clear();
+}
+
+// Enable or disable incremental evaluation
+void EnvImage::setIncremental(bool inputIncremental) {
+    dataIncremental = inputIncremental;
+    cache_clear();
+}
+
+// Check whether incremental evaluation is enabled
+bool EnvImage::getIncremental() const {
+    return dataIncremental;
+}
+
+// Get the rendering backend
+RENDERER EnvImage::getRenderer() const {
+    return dataRenderer;
+}
+
+// Set the comparison strategy
+void EnvImage::setComparison(const Comparison& inputComparison) {
+    dataComparison = inputComparison;
+    cache_clear();
+
+    // Prepare the comparison data of the new strategy
+    if (!dataInputFile.empty())
+        load(dataInputFile);
+}
+
+// Get the comparison strategy
+const Comparison& EnvImage::getComparison() const {
+    return dataComparison;
+}
 
 
 //
-// Comparison setup
+// Drawing helper routines
 //
 
-// Setup the comparison data
-void EnvImage::setup(cairo_surface_t* inputSurface) {
-    switch(COMPARISON_METHOD) {
-        case 0:
-            setup_nmse(inputSurface);
-            break;
-        case 1:
-            setup_average(inputSurface);
-            break;
-    }
+// Decode a gene into a colour code and a list of points, in drawing order
+//   returns the amount of points, or 0 if the gene doesn't hold a valid
+//   polygon (a colour code and 3 to LIMIT_POLYGON_POINTS-1 points)
+unsigned int EnvImage::help_polygon(const Gene& inputGene, vertex* outputPoints, int* outputColour) const {
+    return help_polygon(inputGene, outputPoints, outputColour, dataInputWidth, dataInputHeight);
 }
 
-// Setup the comparison data -- Normalised Mean Square Error method
-void EnvImage::setup_nmse(cairo_surface_t* inputSurface) {
-        std::cout << "NOTE: using NMSE comparison method" << std::endl;
+// Decode a gene for an image of a given size
+unsigned int EnvImage::help_polygon(const Gene& inputGene, vertex* outputPoints, int* outputColour, int inputWidth, int inputHeight) const {
+    unsigned int size = inputGene.size;
+    const unsigned char* gene_ptr = inputGene.data;
+    if (size < 10 || (size-4)/2 >= LIMIT_POLYGON_POINTS)
+        return 0;
+
+    // Get colour code
+    for (int c = 0; c < 4; c++)
+        outputColour[c] = *(gene_ptr++);
+
+    // Save all points in a container
+    // Points vary between 1 and 254, so let 1 be the lower bound and 254 the upper one
+    vertex points[LIMIT_POLYGON_POINTS];
+    const int points_count = (size-4)/2;
+    for (int i = 0; i < points_count; i++) {
+        int x = *(gene_ptr++) - 1;
+        int y = *(gene_ptr++) - 1;
+        points[i].x = inputWidth * x / 253.0;
+        points[i].y = inputHeight * y / 253.0;
+        points[i].drawn = false;
+    }
 
-        // Get data
-        unsigned char* tempData = cairo_image_surface_get_data(inputSurface);
+    // Sort the points to avoid complex polygons
+    // http://www.computational-geometry.org/mailing-lists/compgeom-announce/2003-March/000731.html
+    int start = 0;	// upper left point is starting point
+    for (int i = 0; i < points_count; i++) {
+        if (points[i].y > points[start].y)
+            start = i;
+        else if (points[i].y == points[start].y && points[i].x < points[start].x)
+            start = i;
+    }
+    outputPoints[0] = points[start];
+    points[start].drawn = true;
+    for (int i = 0; i < points_count; i++) {    // calculate angle for each point against startpoint
+        if (i == start)
+            continue;
+        points[i].angle =  atan2(points[i].y - points[start].y, points[i].x - points[start].x);
+    }
+    for (int i = 1; i < points_count; i++) {    // order points based on increasing angle
+        double angle = 0;
+        int next = -1;
+        for (int j = 0; j < points_count; j++) {
+            if (points[j].drawn)
+                continue;
+            if (next == -1 || points[j].angle < angle) {
+                angle = points[j].angle;
+                next = j;
+            }
+        }
+        outputPoints[i] = points[next];
+        points[next].drawn = true;
+    }
 
-        // Copy data (TODO: memcpy)
-        data_nmse = new unsigned char[dataInputHeight*dataInputWidth*4+1];
-        for (int i = 0; i < dataInputHeight*dataInputWidth*4; i++)
-            data_nmse[i] = *(tempData++);
+    return points_count;
 }
 
-// Setup the comparison data -- averaging method
-void EnvImage::setup_average(cairo_surface_t* inputSurface) {
-        std::cout << "NOTE: using block-averaging comparison method" << std::endl;
+// Render (a range of the genes of) the DNA code with the native rasteriser,
+// onto an image of a given size
+void EnvImage::help_draw(Raster& inputRaster, const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast, int inputWidth, int inputHeight) const {
+    vertex points[LIMIT_POLYGON_POINTS];
+    int colour[4];
 
-        // Get data
-        unsigned char* tempData = cairo_image_surface_get_data(inputSurface);
+    // Loop all genes
+    inputLast = std::min(inputLast, inputDNA->genes());
+    for (DNA::const_iterator it(inputDNA, inputFirst), end(inputDNA, std::max(inputFirst, inputLast)); it != end; ++it) {
+        unsigned int points_count = help_polygon(*it, points, colour, inputWidth, inputHeight);
+        if (points_count == 0)
+            continue;
+
+        // Scale the colour code from 1-254 to 0-255
+        unsigned char channels[4];
+        for (int c = 0; c < 4; c++)
+            channels[c] = std::min(((colour[c] - 1) * 255 + 126) / 253, 255);
+        inputRaster.fill(points, points_count, channels[0], channels[1], channels[2], channels[3]);
+    }
+}
 
-	// Calculate 32x32 colour matrixes for image A
-	data_average = new int[3*AVERAGE_DIV_X*AVERAGE_DIV_Y];
-	help_average_divide(tempData, data_average, dataInputWidth, dataInputHeight);
+// Calculate the bounds of the pixels a gene draws on
+//   the points have integer coordinates, so the region spanned by them
+//   suffices for the native rasteriser; a margin is added for the
+//   anti-aliasing of Cairo
+bool EnvImage::help_bounds(const Gene& inputGene, region& outputBounds) const {
+    vertex points[LIMIT_POLYGON_POINTS];
+    int colour[4];
+    unsigned int points_count = help_polygon(inputGene, points, colour);
+    if (points_count == 0)
+        return false;
+
+    outputBounds.left = outputBounds.right = points[0].x;
+    outputBounds.top = outputBounds.bottom = points[0].y;
+    for (unsigned int i = 1; i < points_count; i++) {
+        outputBounds.left = std::min(outputBounds.left, points[i].x);
+        outputBounds.right = std::max(outputBounds.right, points[i].x);
+        outputBounds.top = std::min(outputBounds.top, points[i].y);
+        outputBounds.bottom = std::max(outputBounds.bottom, points[i].y);
+    }
+    outputBounds.left = std::max(outputBounds.left - 1, 0);
+    outputBounds.top = std::max(outputBounds.top - 1, 0);
+    outputBounds.right = std::min(outputBounds.right + 1, dataInputWidth);
+    outputBounds.bottom = std::min(outputBounds.bottom + 1, dataInputHeight);
+    return outputBounds.left < outputBounds.right && outputBounds.top < outputBounds.bottom;
+}
+
+// Render a range of genes onto the scratch surface, on top of its contents,
+// and optionally restricted to a region
+void EnvImage::help_render(const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast, const region* inputClip) {
+    if (dataRenderer == RENDERER_NATIVE) {
+        dataRaster.setTarget(cairo_image_surface_get_data(dataSurface), dataInputWidth, dataInputHeight, cairo_image_surface_get_stride(dataSurface));
+        if (inputClip != NULL)
+            dataRaster.setClip(*inputClip);
+        draw(dataRaster, inputDNA, inputFirst, inputLast);
+    } else {
+        cairo_surface_mark_dirty(dataSurface);
+        if (inputClip != NULL) {
+            cairo_save(dataContext);
+            cairo_rectangle(dataContext, inputClip->left, inputClip->top, inputClip->right - inputClip->left, inputClip->bottom - inputClip->top);
+            cairo_clip(dataContext);
+        }
+        draw(dataContext, inputDNA, inputFirst, inputLast);
+        if (inputClip != NULL)
+            cairo_restore(dataContext);
+        cairo_surface_flush(dataSurface);
+    }
 }
 
 
 //
-// Image comparison
+// Comparison setup
 //
 
-// Compare two images
-double EnvImage::compare(cairo_surface_t* inputSurface) const {
-    switch(COMPARISON_METHOD)
-    {
-        case 0:
-            return compare_nmse(inputSurface);
+// Setup the comparison data
+void EnvImage::setup(cairo_surface_t* inputSurface) {
+    switch(dataComparison.getMethod()) {
+        case COMPARISON_NMSE:
+            std::cout << "NOTE: using NMSE comparison method" << std::endl;
             break;
-        case 1:
-            return compare_average(inputSurface);
+        case COMPARISON_AVERAGE:
+            std::cout << "NOTE: using block-averaging comparison method" << std::endl;
+            break;
+        case COMPARISON_PYRAMID:
+            std::cout << "NOTE: using pyramid comparison method" << std::endl;
             break;
-        default:
-            return 0;
     }
+
+    // Prepare the input image
+    dataComparison.setup(cairo_image_surface_get_data(inputSurface), dataInputWidth, dataInputHeight);
+
+    // Downsample it for the pyramid method
+    dataPyramid.clear();
+    if (dataComparison.getMethod() == COMPARISON_PYRAMID)
+        pyramid_setup();
 }
 
-// Compare two images -- Normalised Mean Square Error method
-double EnvImage::compare_nmse(cairo_surface_t* inputSurface) const
-{
+
+//
+// Image comparison
+//
+
+// Compare an image with the input image
+double EnvImage::compare(cairo_surface_t* inputSurface) const {
     // Get and verify size
     if ((cairo_image_surface_get_width(inputSurface) != dataInputWidth) || (cairo_image_surface_get_height(inputSurface) != dataInputHeight))
     {
@@ -366,101 +543,307 @@ double EnvImage::compare_nmse(cairo_surface_t* inputSurface) const
         return 0;
     }
 
-    // Get the raw data of the given surface
-    unsigned char* tempData1 = data_nmse;
-    unsigned char* tempData2 = cairo_image_surface_get_data(inputSurface);
+    // Calculate similarity
+    const unsigned char* tempData = cairo_image_surface_get_data(inputSurface);
+    return dataComparison.similarity(dataComparison.difference(tempData));
+}
 
-    // Total difference
-    long int difference = 0;
 
-    // Variables
-    int i, db, dg, dr;
-    for (i = 0; i < dataInputWidth*dataInputHeight*4; i+=4)
-    {
-        // RGBa
-        db = tempData1[i] - tempData2[i];
-        dg = tempData1[i+1] - tempData2[i+1];
-        dr = tempData1[i+2] - tempData2[i+2];
+//
+// Scratch surface
+//
 
-        // Calculate difference (Normalised Mean Square Error)
-        difference += sqrt(dr*dr + dg*dg + db*db);
+// Get the scratch surface (and create it if needed)
+cairo_surface_t* EnvImage::scratch() {
+    if (dataSurface == NULL) {
+        dataSurface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, dataInputWidth, dataInputHeight);
+        dataContext = cairo_create(dataSurface);
     }
-
-    // Calculate similarity
-    double similarity = 1.0 - ((double) difference / (sqrt(3.0*255.0*255.0) * dataInputWidth * dataInputHeight));
-    return similarity;
+    return dataSurface;
 }
 
 
-// Compare two images -- averaging method
-double EnvImage::compare_average(cairo_surface_t* inputSurface) const
-{
-    // Verify formats
-    if (cairo_image_surface_get_format(inputSurface) != CAIRO_FORMAT_RGB24)
-    {
-        std::cout << "WARNING: can only process RGB24 data" << std::endl;
+//
+// Render cache
+//
+
+// Amount of leading genes a DNA string shares with the cached string
+//   the genes before the first one modified since the string got copied
+//   (typically off the best string, by a mutating client) are likely to
+//   be shared with the cached string, which gets verified
+unsigned int EnvImage::cache_prefix(const DNA* inputDNA) const {
+    if (dataReference == NULL)
         return 0;
+
+    // Bound the shared prefix
+    unsigned int tempGenes = std::min(inputDNA->modified_gene(), std::min(inputDNA->genes(), dataReference->genes()));
+
+    // Verify it
+    for (unsigned int i = 0; i < tempGenes; i++) {
+        Gene tempGene = inputDNA->gene(i), tempReference = dataReference->gene(i);
+        if (tempGene.size != tempReference.size || std::memcmp(tempGene.data, tempReference.data, tempGene.size) != 0)
+            return i;
     }
+    return tempGenes;
+}
 
-    // Get the raw data of the given surface
-    unsigned char* tempDataB = cairo_image_surface_get_data(inputSurface);
+// Amount of trailing genes a DNA string shares with the cached string,
+// not overlapping with the given shared prefix
+unsigned int EnvImage::cache_suffix(const DNA* inputDNA, unsigned int inputPrefix) const {
+    unsigned int tempGenes = inputDNA->genes(), tempReferenceGenes = dataReference->genes();
+    unsigned int tempMax = std::min(tempGenes, tempReferenceGenes) - inputPrefix;
+    for (unsigned int i = 0; i < tempMax; i++) {
+        Gene tempGene = inputDNA->gene(tempGenes-1-i), tempReference = dataReference->gene(tempReferenceGenes-1-i);
+        if (tempGene.size != tempReference.size || std::memcmp(tempGene.data, tempReference.data, tempGene.size) != 0)
+            return i;
+    }
+    return tempMax;
+}
 
-    // Calculate 32x32 colour matrixes for image B
-    int* avgB = new int[3 * AVERAGE_DIV_X * AVERAGE_DIV_Y];
-    help_average_divide(tempDataB, avgB, dataInputWidth, dataInputHeight);
+// Cache the layers of a new best string
+//   the given amount of layers is shared with the previous best string, so
+//   rendering can resume from there
+void EnvImage::cache_store(const DNA* inputDNA, double inputFitness, unsigned int inputLayers) {
+    if (dataReference == NULL)
+        dataReference = new DNA(*inputDNA);
+    else
+        *dataReference = *inputDNA;
+    dataReferenceFitness = inputFitness;
+
+    // Layers are only kept for prefixes shorter than the string itself
+    unsigned int tempCount = (inputDNA->genes() - 1) / IMAGE_LAYER_INTERVAL;
+    inputLayers = std::min(inputLayers, tempCount);
+    unsigned char* tempData = cairo_image_surface_get_data(dataSurface);
+    int tempSize = cairo_image_surface_get_stride(dataSurface) * dataInputHeight;
+    dataLayers.resize(tempCount*tempSize);
+
+    // Render the missing layers
+    cairo_surface_flush(dataSurface);
+    if (inputLayers > 0)
+        std::memcpy(tempData, &dataLayers[(inputLayers-1)*tempSize], tempSize);
+    else
+        std::memset(tempData, 0xFF, tempSize);
+    for (unsigned int i = inputLayers; i < tempCount; i++) {
+        help_render(inputDNA, i*IMAGE_LAYER_INTERVAL, (i+1)*IMAGE_LAYER_INTERVAL);
+        std::memcpy(&dataLayers[i*tempSize], tempData, tempSize);
+    }
+    dataLayerCount = tempCount;
 
-    // Compare colour matrices
-    long int difference = 0;
-    for (int i = 0; i < 3 * AVERAGE_DIV_X * AVERAGE_DIV_Y; i++) {
-        difference += std::abs(data_average[i] - avgB[i]);
+    // Keep the final rendering, for incremental evaluation
+    if (dataIncremental) {
+        help_render(inputDNA, tempCount*IMAGE_LAYER_INTERVAL, inputDNA->genes());
+        dataCanvas.assign(tempData, tempData + tempSize);
+        cache_measure();
     }
 
-    // Clean up
-    delete[] avgB;
+    // Score it at the lower resolutions
+    if (dataComparison.getMethod() == COMPARISON_PYRAMID)
+        pyramid_measure(inputLayers);
+}
 
-    // Calculate similarity
-    double similarity = 1.0 - ((double) difference / (255.0 * AVERAGE_DIV_X * AVERAGE_DIV_Y * 3.0));
-    return similarity;
+// Calculate the comparison data of the final rendering of the cached string
+void EnvImage::cache_measure() {
+    if (dataComparison.getMethod() == COMPARISON_AVERAGE) {
+        dataBlockSums.resize(3*dataComparison.blocks());
+        dataComparison.block_sums(&dataCanvas[0], &dataBlockSums[0]);
+        dataDifference = 0;
+        for (int b = 0; b < dataComparison.blocks(); b++)
+            dataDifference += dataComparison.block_difference(b, &dataBlockSums[3*b]);
+    } else {
+        dataDifference = dataComparison.difference(&dataCanvas[0]);
+    }
+}
+
+// Empty the render cache
+void EnvImage::cache_clear() {
+    if (dataReference != NULL)
+        delete dataReference;
+    dataReference = NULL;
+    dataLayers.clear();
+    dataLayerCount = 0;
+    dataCanvas.clear();
 }
 
 
 //
-// Comparison helper routines
+// Incremental evaluation
 //
 
-// Subdivide an image into 32x32 blocks
-void EnvImage::help_average_divide(unsigned char* rgb, int* avg, int width, int height) const {
-	// Calculate step sizes
-	int step_x = width/AVERAGE_DIV_X;
-	int step_y = height/AVERAGE_DIV_Y;
-
-	// Process all blocks
-    int r = 0, g = 0, b = 0;
-	int y_max = 0;
-	for (int ys = 0; ys < AVERAGE_DIV_Y; ys++) {
-		int x_max = 0;
-		for (int xs = 0; xs < AVERAGE_DIV_X; xs++) {
-
-			// Calculate colour in block
-			for (int y = y_max; y < y_max+step_y; y++) {
-				for (int x = x_max; x < x_max+step_x; x++) {
-					r += *(rgb++);
-					g += *(rgb++);
-					b += *(rgb++);
-					rgb++;		// Skip alpha
-				}
-				x_max += step_x;
-			}
-			y_max += step_y;
-
-			r /= step_x*step_y;
-			g /= step_x*step_y;
-			b /= step_x*step_y;
-
-			// Save colours
-			*(avg++) = r;
-			*(avg++) = g;
-			*(avg++) = b;
-		}
-	}
+// Fitness of a DNA string which shares a prefix (and some cached layers)
+// with the cached string
+//   only the genes in between the shared prefix and suffix differ, so only
+//   the pixels within their bounds (before and after the modification) get
+//   rendered, starting from the cached layer, and compared
+double EnvImage::fitness_region(const DNA* inputDNA, unsigned int inputPrefix, unsigned int inputLayers) {
+    // Calculate the bounds of the modified genes
+    unsigned int tempSuffix = cache_suffix(inputDNA, inputPrefix);
+    region tempRegion = {dataInputWidth, dataInputHeight, 0, 0}, tempBounds;
+    for (unsigned int i = inputPrefix; i+tempSuffix < dataReference->genes(); i++) {
+        if (help_bounds(dataReference->gene(i), tempBounds)) {
+            tempRegion.left = std::min(tempRegion.left, tempBounds.left);
+            tempRegion.top = std::min(tempRegion.top, tempBounds.top);
+            tempRegion.right = std::max(tempRegion.right, tempBounds.right);
+            tempRegion.bottom = std::max(tempRegion.bottom, tempBounds.bottom);
+        }
+    }
+    for (unsigned int i = inputPrefix; i+tempSuffix < inputDNA->genes(); i++) {
+        if (help_bounds(inputDNA->gene(i), tempBounds)) {
+            tempRegion.left = std::min(tempRegion.left, tempBounds.left);
+            tempRegion.top = std::min(tempRegion.top, tempBounds.top);
+            tempRegion.right = std::max(tempRegion.right, tempBounds.right);
+            tempRegion.bottom = std::max(tempRegion.bottom, tempBounds.bottom);
+        }
+    }
+
+    // Nothing got drawn differently
+    if (tempRegion.left >= tempRegion.right || tempRegion.top >= tempRegion.bottom)
+        return dataReferenceFitness;
+
+    // Start from a cached layer, or white
+    unsigned char* tempData = cairo_image_surface_get_data(dataSurface);
+    int tempStride = cairo_image_surface_get_stride(dataSurface);
+    int tempOffset = 4*tempRegion.left, tempLength = 4*(tempRegion.right - tempRegion.left);
+    cairo_surface_flush(dataSurface);
+    for (int y = tempRegion.top; y < tempRegion.bottom; y++) {
+        if (inputLayers > 0)
+            std::memcpy(tempData + y*tempStride + tempOffset, &dataLayers[(inputLayers-1)*tempStride*dataInputHeight + y*tempStride + tempOffset], tempLength);
+        else
+            std::memset(tempData + y*tempStride + tempOffset, 0xFF, tempLength);
+    }
+
+    // Draw the remaining genes within the region, and compare it
+    help_render(inputDNA, inputLayers*IMAGE_LAYER_INTERVAL, inputDNA->genes(), &tempRegion);
+    return compare_region(tempRegion);
+}
+
+// Compare a region of the scratch surface, with the final rendering of the
+// cached string in the rest of the image
+//   the difference gets updated with the change within the region; for the
+//   averaging method, only the blocks covering the region get recalculated
+//   from their cached channel sums
+double EnvImage::compare_region(const region& inputRegion) {
+    const unsigned char* tempData = cairo_image_surface_get_data(dataSurface);
+    long tempDifference = dataDifference;
+
+    if (dataComparison.getMethod() == COMPARISON_AVERAGE) {
+        int tempColumns = dataComparison.column(dataInputWidth-1) + 1;
+        int tempFirstColumn = dataComparison.column(inputRegion.left), tempLastColumn = dataComparison.column(inputRegion.right-1);
+        int tempFirstRow = dataComparison.row(inputRegion.top), tempLastRow = dataComparison.row(inputRegion.bottom-1);
+        for (int r = tempFirstRow; r <= tempLastRow; r++) {
+            for (int c = tempFirstColumn; c <= tempLastColumn; c++) {
+                // Accumulate the change of the channel sums within the region
+                region tempBlock = dataComparison.block(c, r);
+                int tempLeft = std::max(tempBlock.left, inputRegion.left), tempRight = std::min(tempBlock.right, inputRegion.right);
+                int tempTop = std::max(tempBlock.top, inputRegion.top), tempBottom = std::min(tempBlock.bottom, inputRegion.bottom);
+                long tempNew[3] = {0, 0, 0}, tempOld[3] = {0, 0, 0};
+                int tempOffset = 4*(tempTop*dataInputWidth + tempLeft);
+                kernel_sum(tempData + tempOffset, tempRight - tempLeft, tempBottom - tempTop, 4*dataInputWidth, tempNew);
+                kernel_sum(&dataCanvas[tempOffset], tempRight - tempLeft, tempBottom - tempTop, 4*dataInputWidth, tempOld);
+
+                // Recalculate the block
+                int tempBlockIndex = r*tempColumns + c;
+                long* tempSums = &dataBlockSums[3*tempBlockIndex];
+                long tempChanged[3];
+                for (int i = 0; i < 3; i++)
+                    tempChanged[i] = tempSums[i] + tempNew[i] - tempOld[i];
+                tempDifference += dataComparison.block_difference(tempBlockIndex, tempChanged) - dataComparison.block_difference(tempBlockIndex, tempSums);
+            }
+        }
+    } else {
+        tempDifference += dataComparison.difference_nmse(tempData, inputRegion) - dataComparison.difference_nmse(&dataCanvas[0], inputRegion);
+    }
+
+    return dataComparison.similarity(tempDifference);
+}
+
+//
+// Pyramid screening
+//
+
+// Downsample the input image
+//   every level divides the resolution of the previous one by PYRAMID_FACTOR,
+//   averaging blocks of pixels
+void EnvImage::pyramid_setup() {
+    const unsigned char* tempSource = dataComparison.target();
+    int tempWidth = dataInputWidth;
+    dataPyramid.reserve(PYRAMID_LEVELS);
+    while (dataPyramid.size() < PYRAMID_LEVELS) {
+        Level tempLevel;
+        tempLevel.width = (dataPyramid.empty() ? dataInputWidth : dataPyramid.back().width) / PYRAMID_FACTOR;
+        tempLevel.height = (dataPyramid.empty() ? dataInputHeight : dataPyramid.back().height) / PYRAMID_FACTOR;
+        if (tempLevel.width < PYRAMID_MINIMUM || tempLevel.height < PYRAMID_MINIMUM)
+            break;
+        tempLevel.reference = 0;
+        tempLevel.target.resize(4*tempLevel.width*tempLevel.height);
+        for (int y = 0; y < tempLevel.height; y++) {
+            for (int x = 0; x < tempLevel.width; x++) {
+                for (int c = 0; c < 4; c++) {
+                    int tempSum = 0;
+                    for (int dy = 0; dy < PYRAMID_FACTOR; dy++)
+                        for (int dx = 0; dx < PYRAMID_FACTOR; dx++)
+                            tempSum += tempSource[4*((PYRAMID_FACTOR*y + dy)*tempWidth + PYRAMID_FACTOR*x + dx) + c];
+                    tempLevel.target[4*(y*tempLevel.width + x) + c] = (tempSum + PYRAMID_FACTOR*PYRAMID_FACTOR/2) / (PYRAMID_FACTOR*PYRAMID_FACTOR);
+                }
+            }
+        }
+        dataPyramid.push_back(tempLevel);
+        tempSource = &dataPyramid.back().target[0];
+        tempWidth = tempLevel.width;
+    }
+}
+
+// Difference between a DNA string and the input image at a lower resolution
+//   the string gets rendered by the native rasteriser, whatever the
+//   rendering backend, onto the canvas of the level, starting from the
+//   given amount of cached layers
+long EnvImage::pyramid_difference(Level& inputLevel, const DNA* inputDNA, unsigned int inputLayers) {
+    int tempSize = 4*inputLevel.width*inputLevel.height;
+    if (inputLayers > 0)
+        inputLevel.canvas.assign(inputLevel.layers.begin() + (inputLayers-1)*tempSize, inputLevel.layers.begin() + inputLayers*tempSize);
+    else
+        inputLevel.canvas.assign(tempSize, 0xFF);
+    dataRaster.setTarget(&inputLevel.canvas[0], inputLevel.width, inputLevel.height, 4*inputLevel.width);
+    help_draw(dataRaster, inputDNA, inputLayers*IMAGE_LAYER_INTERVAL, inputDNA->genes(), inputLevel.width, inputLevel.height);
+    return kernel_distance(&inputLevel.target[0], &inputLevel.canvas[0], inputLevel.width*inputLevel.height);
+}
+
+// Screen a DNA string at the lower resolutions, starting with the lowest one
+//   returns false when it scores worse than the cached string by more than
+//   the threshold at any level, in which case the string gets the fitness of
+//   a rejected one
+bool EnvImage::pyramid_screen(const DNA* inputDNA, unsigned int inputLayers, double& outputFitness) {
+    for (unsigned int i = dataPyramid.size(); i > 0; i--) {
+        Level& tempLevel = dataPyramid[i-1];
+        long tempDifference = pyramid_difference(tempLevel, inputDNA, inputLayers);
+        double tempLoss = (tempDifference - tempLevel.reference) / (sqrt(3.0*255.0*255.0) * tempLevel.width * tempLevel.height);
+        if (tempLoss > dataComparison.getThreshold()) {
+            outputFitness = PYRAMID_REJECTED;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Score the cached string at the lower resolutions, and cache its layers
+// there as well (of which the given amount is still valid)
+void EnvImage::pyramid_measure(unsigned int inputLayers) {
+    inputLayers = std::min(inputLayers, dataLayerCount);
+    for (unsigned int i = 0; i < dataPyramid.size(); i++) {
+        Level& tempLevel = dataPyramid[i];
+        int tempSize = 4*tempLevel.width*tempLevel.height;
+        tempLevel.layers.resize(dataLayerCount*tempSize);
+
+        // Render the missing layers
+        if (inputLayers > 0)
+            tempLevel.canvas.assign(tempLevel.layers.begin() + (inputLayers-1)*tempSize, tempLevel.layers.begin() + inputLayers*tempSize);
+        else
+            tempLevel.canvas.assign(tempSize, 0xFF);
+        dataRaster.setTarget(&tempLevel.canvas[0], tempLevel.width, tempLevel.height, 4*tempLevel.width);
+        for (unsigned int l = inputLayers; l < dataLayerCount; l++) {
+            help_draw(dataRaster, dataReference, l*IMAGE_LAYER_INTERVAL, (l+1)*IMAGE_LAYER_INTERVAL, tempLevel.width, tempLevel.height);
+            std::copy(tempLevel.canvas.begin(), tempLevel.canvas.end(), tempLevel.layers.begin() + l*tempSize);
+        }
+
+        tempLevel.reference = pyramid_difference(tempLevel, dataReference, dataLayerCount);
+    }
 }
@@ -48,10 +48,16 @@
 #include "../../populations/singlestraight.h"
 #include "../../environment.h"
 #include "../../dna.h"
+#include "raster.h"
+#include "kernels.h"
+#include "comparison.h"
 #include <vector>
 #include <cmath>
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <climits>
 #include <cairo/cairo.h>
 #ifdef WITH_OPENMP
 #include <omp.h>
@@ -69,24 +75,32 @@ const int IMAGE_DIGITS = 5;
 const unsigned int LIMIT_POLYGONS = 50;
 const unsigned int LIMIT_POLYGON_POINTS = 5;
 
-// Division settings
-const int AVERAGE_DIV_X = 32;
-const int AVERAGE_DIV_Y = 32;
+// Pyramid settings: amount of lower resolution levels, each one dividing
+// the resolution of the previous one by a factor, down to a minimal size
+const unsigned int PYRAMID_LEVELS = 1;
+const int PYRAMID_FACTOR = 4;
+const int PYRAMID_MINIMUM = 16;
 
-// Comparison method
-const int COMPARISON_METHOD = 1;
+// Fitness of strings rejected at a lower resolution: the worst possible
+// value (like invalid strings get), as they never got scored in full
+const double PYRAMID_REJECTED = 0;
 
+// Rendering backends
+enum RENDERER {
+    RENDERER_CAIRO,     // anti-aliased, through a Cairo context
+    RENDERER_NATIVE     // aliased, through the built-in scanline rasteriser
+};
 
-//
-// Additional structures
-//
+// Default rendering backend for fitness evaluation
+const RENDERER IMAGE_RENDERER = RENDERER_CAIRO;
 
-struct vertex {
-    int x;
-    int y;
-    bool drawn;
-    double angle;
-};
+// Render cache: a copy of the canvas is kept after every so many genes of
+// the best string evaluated so far
+const unsigned int IMAGE_LAYER_INTERVAL = 8;
+
+// Incremental evaluation: only re-render and re-compare the region in which
+// a string differs from the best string so far
+const bool IMAGE_INCREMENTAL = false;
 
 
 
@@ -100,34 +114,107 @@ class EnvImage : public Environment
 	public:
 		// Construction & destruction
 		EnvImage();
+		EnvImage(const Comparison& inputComparison);
+		EnvImage(const EnvImage& inputEnvironment);
 		~EnvImage();
 
 		// Required functons
 		double fitness(const DNA* inputDNA);
+		void fitness(const DNA* const* inputDNA, double* outputFitness, unsigned int inputSize);
 		int alphabet() const;
 
 		// Image functions
 		bool load(std::string inputFile);
 		void draw(cairo_surface_t* inputSurface, const DNA* inputDNA) const;
+		void draw(cairo_t* inputContext, const DNA* inputDNA, unsigned int inputFirst = 0, unsigned int inputLast = UINT_MAX) const;
+		void draw(Raster& inputRaster, const DNA* inputDNA, unsigned int inputFirst = 0, unsigned int inputLast = UINT_MAX) const;
                 void explain(const DNA* inputDNA) const;
 
+                // Rendering backend (final output always uses Cairo)
+                void setRenderer(RENDERER inputRenderer);
+                RENDERER getRenderer() const;
+
+                // Incremental evaluation
+                void setIncremental(bool inputIncremental);
+                bool getIncremental() const;
+
+                // Comparison strategy (which reloads the input image)
+                void setComparison(const Comparison& inputComparison);
+                const Comparison& getComparison() const;
+
                 // Comparison setup
                 void setup(cairo_surface_t* inputSurface);
-                void setup_nmse(cairo_surface_t* inputSurface);
-                void setup_average(cairo_surface_t* inputSurface);
 
                 // Image comparison
 		double compare(cairo_surface_t* inputSurface) const;
-                double compare_nmse(cairo_surface_t* inputSurface) const;
-		double compare_average(cairo_surface_t* inputSurface) const;
 
         private:
-                // Comparison helper functions
-                void help_average_divide(unsigned char* rgb, int* avg, int width, int height) const;
-
-                // Comparison data
-                unsigned char* data_nmse;
-                int* data_average;
+                // Lower resolution level of the pyramid method
+                struct Level {
+                    int width, height;
+                    std::vector<unsigned char> target;  // downsampled input image
+                    std::vector<unsigned char> canvas;  // rendering surface
+                    std::vector<unsigned char> layers;  // render cache (see dataLayers)
+                    long reference;                     // difference of the cached string
+                };
+
+                // Drawing helper functions
+                unsigned int help_polygon(const Gene& inputGene, vertex* outputPoints, int* outputColour) const;
+                unsigned int help_polygon(const Gene& inputGene, vertex* outputPoints, int* outputColour, int inputWidth, int inputHeight) const;
+                void help_draw(Raster& inputRaster, const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast, int inputWidth, int inputHeight) const;
+                bool help_bounds(const Gene& inputGene, region& outputBounds) const;
+                void help_render(const DNA* inputDNA, unsigned int inputFirst, unsigned int inputLast, const region* inputClip = NULL);
+
+                // Render cache
+                unsigned int cache_prefix(const DNA* inputDNA) const;
+                unsigned int cache_suffix(const DNA* inputDNA, unsigned int inputPrefix) const;
+                void cache_store(const DNA* inputDNA, double inputFitness, unsigned int inputLayers);
+                void cache_measure();
+                void cache_clear();
+
+                // Incremental evaluation
+                double fitness_region(const DNA* inputDNA, unsigned int inputPrefix, unsigned int inputLayers);
+                double compare_region(const region& inputRegion);
+
+                // Pyramid screening
+                void pyramid_setup();
+                long pyramid_difference(Level& inputLevel, const DNA* inputDNA, unsigned int inputLayers);
+                bool pyramid_screen(const DNA* inputDNA, unsigned int inputLayers, double& outputFitness);
+                void pyramid_measure(unsigned int inputLayers);
+
+                // Scratch surface
+                cairo_surface_t* scratch();
+
+                // Comparison strategy, and the lower resolution levels of
+                // the pyramid method
+                Comparison dataComparison;
+                std::vector<Level> dataPyramid;
+
+                // Scratch surface and context, reused by all fitness
+                // evaluations of this instance (and thus per thread, as
+                // every evaluator thread owns its own clone)
+                cairo_surface_t* dataSurface;
+                cairo_t* dataContext;
+
+                // Rendering backend, and the rasteriser used by the native one
+                RENDERER dataRenderer;
+                Raster dataRaster;
+
+                // Render cache: the best string evaluated by this instance,
+                // and the scratch surface contents after every
+                // IMAGE_LAYER_INTERVAL of its genes (except for the last ones)
+                DNA* dataReference;
+                double dataReferenceFitness;
+                std::vector<unsigned char> dataLayers;
+                unsigned int dataLayerCount;
+
+                // Incremental evaluation: the final rendering of the best
+                // string, its difference from the input image, and (for the
+                // averaging method) its per-block channel sums
+                bool dataIncremental;
+                std::vector<unsigned char> dataCanvas;
+                long dataDifference;
+                std::vector<long> dataBlockSums;
 
 	protected:
 		std::string dataInputFile;
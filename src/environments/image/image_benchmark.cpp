@@ -30,6 +30,7 @@
 
 // Headers
 #include "image.h"
+#include "../../generic.h"
 #include <iostream>
 #include <queue>
 #include <cmath>
@@ -39,6 +40,7 @@
 #include "../../populations/groupstraight.h"
 #include "../../populations/populationstraight.h"
 #include "../../populations/populationdual.h"
+#include "../../populations/island.h"
 #include <cairo/cairo.h>
 #include "../../../lib/gnuplot/gnuplot.h"
 
@@ -67,6 +69,7 @@ class EnvImgBenchmark : public EnvImage
         // Required functions
         void update(const DNA* inputDNA);
         bool condition();
+        Environment* clone() const;
 
         // Additional functions
         void reset();
@@ -109,7 +112,7 @@ void EnvImgBenchmark::update(const DNA* inputDNA) {
     #ifdef WITH_OPENMP
     double tempTime = omp_get_wtime()-start;
     #else
-    double tempTime = (double(clock())-start)/CLOCKS_PER_SEC;
+    double tempTime = wall_time()-start;
     #endif
 
     // Add values to map
@@ -122,11 +125,16 @@ bool EnvImgBenchmark::condition() {
     #ifdef WITH_OPENMP
     double sec = omp_get_wtime()-start;
     #else
-    double sec = (double(clock())-start)/CLOCKS_PER_SEC;
+    double sec = wall_time()-start;
     #endif
     return sec < runtime;
 }
 
+// Clone call
+Environment* EnvImgBenchmark::clone() const {
+    return new EnvImgBenchmark(*this);
+}
+
 
 //
 // Additional functions
@@ -140,7 +148,7 @@ void EnvImgBenchmark::reset()
     #ifdef WITH_OPENMP
     start = omp_get_wtime();
     #else
-	start = (double)clock();
+	start = wall_time();
 	#endif
 }
 
@@ -206,6 +214,10 @@ int main(int argc, char** argv)
 	// Time of runs
 	int inputTime = argc>=4 ? atoi(argv[3]) : BENCHMARK_SECONDS;
 
+	// Random seed (every run starts from the same seed)
+	uint64_t inputSeed = argc>=5 ? strtoull(argv[4], 0, 10) : (uint64_t) time(0);
+	std::cout << "* Using seed " << inputSeed << std::endl;
+
 
 
 	// Message
@@ -251,6 +263,7 @@ int main(int argc, char** argv)
 	try
     {
         dataEnvironment.reset();
+        random_seed(inputSeed);
         Population* dataPopulation = new PopSingleStraight(&dataEnvironment, tempDNA);
         dataEnvironment.setVector(&dataSingleStraightTime, &dataSingleStraightFitness);
         dataPopulation->evolve();
@@ -269,7 +282,9 @@ int main(int argc, char** argv)
 	try
     {
         dataEnvironment.reset();
+        random_seed(inputSeed);
         Population* dataPopulation = new PopGroupStraight(&dataEnvironment, tempDNA);
+        dataPopulation->setEvaluator(new EvalPool(&dataEnvironment));
         dataEnvironment.setVector(&dataGroupStraightTimes, &dataGroupStraightFitness);
         dataPopulation->evolve();
         delete dataPopulation;
@@ -287,12 +302,35 @@ int main(int argc, char** argv)
 	try
     {
         dataEnvironment.reset();
+        random_seed(inputSeed);
         Population* dataPopulation = new PopPopulationStraight(&dataEnvironment, tempDNA);
+        dataPopulation->setEvaluator(new EvalPool(&dataEnvironment));
         dataEnvironment.setVector(&dataPopulationStraightTime, &dataPopulationStraightFitness);
         dataPopulation->evolve();
         delete dataPopulation;
     }
     catch (std::string error)
+    {
+        std::cout << "! Error: " << error << std::endl;
+        return 1;
+    }
+
+	// Population steady-state
+	std::cout << "\t- Testing POPULATION STEADY evolution" << std::endl;
+	std::vector<double> dataPopulationSteadyTime;
+	std::vector<double> dataPopulationSteadyFitness;
+	try
+    {
+        dataEnvironment.reset();
+        random_seed(inputSeed);
+        Population* dataPopulation = new PopPopulationStraight(&dataEnvironment, tempDNA);
+        dataPopulation->setEvaluator(new EvalPool(&dataEnvironment));
+        dataPopulation->setSteady(true);
+        dataEnvironment.setVector(&dataPopulationSteadyTime, &dataPopulationSteadyFitness);
+        dataPopulation->evolve();
+        delete dataPopulation;
+    }
+    catch (std::string error)
     {
         std::cout << "! Error: " << error << std::endl;
         return 1;
@@ -305,12 +343,33 @@ int main(int argc, char** argv)
 	try
     {
         dataEnvironment.reset();
+        random_seed(inputSeed);
         Population* dataPopulation = new PopPopulationDual(&dataEnvironment, tempDNA);
+        dataPopulation->setEvaluator(new EvalPool(&dataEnvironment));
         dataEnvironment.setVector(&dataPopulationDualTime, &dataPopulationDualFitness);
         dataPopulation->evolve();
         delete dataPopulation;
     }
     catch (std::string error)
+    {
+        std::cout << "! Error: " << error << std::endl;
+        return 1;
+    }
+
+	// Islands
+	std::cout << "\t- Testing ISLAND evolution" << std::endl;
+	std::vector<double> dataIslandTime;
+	std::vector<double> dataIslandFitness;
+	try
+    {
+        dataEnvironment.reset();
+        random_seed(inputSeed);
+        Population* dataPopulation = new PopIsland(&dataEnvironment, tempDNA);
+        dataEnvironment.setVector(&dataIslandTime, &dataIslandFitness);
+        dataPopulation->evolve();
+        delete dataPopulation;
+    }
+    catch (std::string error)
     {
         std::cout << "! Error: " << error << std::endl;
         return 1;
@@ -333,7 +392,9 @@ int main(int argc, char** argv)
     plot.plot_xy(dataSingleStraightTime, dataSingleStraightFitness, "single-straight evolution");
     plot.plot_xy(dataGroupStraightTimes, dataGroupStraightFitness, "population evolution");
     plot.plot_xy(dataPopulationStraightTime, dataPopulationStraightFitness, "population-straight evolution");
+    plot.plot_xy(dataPopulationSteadyTime, dataPopulationSteadyFitness, "population-steady evolution");
     plot.plot_xy(dataPopulationDualTime, dataPopulationDualFitness, "population-dual evolution");
+    plot.plot_xy(dataIslandTime, dataIslandFitness, "island evolution");
 
     // Save to file
     plot.savetops(inputFileOutput);
@@ -30,11 +30,14 @@
 
 // Headers
 #include "image.h"
+#include "../../generic.h"
+#include "../../populations/island.h"
 #include <iostream>
 #include <queue>
 #include <cmath>
 #include <sstream>
 #include <ctime>
+#include <cstdio>
 #include <cairo/cairo.h>
 
 
@@ -47,11 +50,12 @@
 class EnvImgWrite : public EnvImage {
 public:
     // Construction & destruction
-    EnvImgWrite();
+    EnvImgWrite(const Comparison& inputComparison);
 
     // Required functions
     void update(const DNA* inputDNA);
     bool condition();
+    Environment* clone() const;
 
     // Additional functions
     void output(cairo_surface_t* inputSurface);
@@ -60,7 +64,8 @@ public:
 private:
     int dataTime;
     int counter;
-    clock_t start;
+    double start;
+    std::string dataTag;
 };
 
 
@@ -73,15 +78,19 @@ private:
 // Construction and destruction
 //
 
-EnvImgWrite::EnvImgWrite() {
+EnvImgWrite::EnvImgWrite(const Comparison& inputComparison) : EnvImage(inputComparison) {
     dataTime = -1;
     counter = 0;
 
 #ifdef WITH_OPENMP
     start = omp_get_wtime();
 #else
-    start = (double) clock();
+    start = wall_time();
 #endif
+
+    // Islands started by the launcher tag their output with their index
+    if (migration_island() >= 0)
+        dataTag = "island" + stringify(migration_island()) + "-";
 }
 
 
@@ -104,7 +113,7 @@ void EnvImgWrite::update(const DNA* inputDNA) {
 #ifdef WITH_OPENMP
     double ms = 1000 * (omp_get_wtime() - start);
 #else
-    long seconds = (double(clock()) - start) / CLOCKS_PER_SEC;
+    long seconds = wall_time() - start;
 #endif
     std::cout << "\t- " << seconds << " sec: " << 100 * fitness(inputDNA) << " points" << std::endl;
 
@@ -119,11 +128,16 @@ bool EnvImgWrite::condition() {
 #ifdef WITH_OPENMP
     double ms = 1000 * (omp_get_wtime() - start);
 #else
-    double ms = 1000 * (double(clock()) - start) / CLOCKS_PER_SEC;
+    double ms = 1000 * (wall_time() - start);
 #endif
     return ms < dataTime * 1000;
 }
 
+// Clone call
+Environment* EnvImgWrite::clone() const {
+    return new EnvImgWrite(*this);
+}
+
 
 //
 // Additional functions
@@ -133,7 +147,7 @@ bool EnvImgWrite::condition() {
 void EnvImgWrite::output(cairo_surface_t* inputSurface) {
     // Generate an output tag
     std::stringstream convert;
-    convert << dataInputFile.substr(0, dataInputFile.find_last_of(".")) << "-";
+    convert << dataInputFile.substr(0, dataInputFile.find_last_of(".")) << "-" << dataTag;
     int zeros = counter == 0 ? IMAGE_DIGITS : IMAGE_DIGITS - log10(counter);
     for (int i = 0; i < zeros; i++)
         convert << "0";
@@ -176,13 +190,50 @@ int main(int argc, char** argv) {
     // Create environment
     //
 
+    // Comparison method and block grid given?
+    Comparison tempComparison;
+    if (argc >= 5) {
+        std::string inputComparison = argv[4];
+        if (inputComparison == "nmse")
+            tempComparison.setMethod(COMPARISON_NMSE);
+        else if (inputComparison == "average")
+            tempComparison.setMethod(COMPARISON_AVERAGE);
+        else if (inputComparison == "pyramid")
+            tempComparison.setMethod(COMPARISON_PYRAMID);
+        else {
+            std::cout << "ERROR: unknown comparison method '" << inputComparison << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (argc >= 6) {
+        int tempColumns, tempRows;
+        if (sscanf(argv[5], "%dx%d", &tempColumns, &tempRows) != 2) {
+            std::cout << "ERROR: block grid should be given as COLUMNSxROWS" << std::endl;
+            return 1;
+        }
+        tempComparison.setGrid(tempColumns, tempRows);
+    }
+
     // Create object
-    EnvImgWrite dataEnvironment;
+    EnvImgWrite dataEnvironment(tempComparison);
 
     // Max time given?
-    if (argc == 3)
+    if (argc >= 3)
         dataEnvironment.runtime(atoi(argv[2]));
 
+    // Rendering backend given? (the output images are always drawn by Cairo)
+    if (argc >= 4) {
+        std::string inputRenderer = argv[3];
+        if (inputRenderer == "native")
+            dataEnvironment.setRenderer(RENDERER_NATIVE);
+        else if (inputRenderer == "cairo")
+            dataEnvironment.setRenderer(RENDERER_CAIRO);
+        else {
+            std::cout << "ERROR: unknown renderer '" << inputRenderer << "'" << std::endl;
+            return 1;
+        }
+    }
+
     // Load base image
     if (!dataEnvironment.load(inputFile)) {
         std::cout << "ERROR: could not load image" << std::endl;
@@ -212,8 +263,16 @@ int main(int argc, char** argv) {
     DNA tempDNA(dnastring, 23);
     dataEnvironment.explain(&tempDNA);
 
-    // Create object
-    Population* dataPopulation = new PopSingleStraight(&dataEnvironment, tempDNA);
+    // Create object (an island population, if started by the launcher)
+    Population* dataPopulation;
+    Migration* tempMigration = migration_connect();
+    if (tempMigration != 0) {
+        PopIsland* tempPopulation = new PopIsland(&dataEnvironment, tempDNA, migration_threads());
+        tempPopulation->setMigration(tempMigration);
+        dataPopulation = tempPopulation;
+        std::cout << "NOTE: running as island " << migration_island() << std::endl;
+    } else
+        dataPopulation = new PopSingleStraight(&dataEnvironment, tempDNA);
 
     // Message
     std::cout << "NOTE: population created" << std::endl;
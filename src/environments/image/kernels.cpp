@@ -0,0 +1,324 @@
+/*
+ * kernels.cpp
+ * Evolve - Image generating environment (comparison kernels)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "kernels.h"
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// AVX2 kernels get compiled for that target separately, and are only used
+// when the processor supports them
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_AVX2
+#include <immintrin.h>
+#endif
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+//
+// Scalar kernels
+//
+
+static long distance_scalar(const unsigned char* inputData1, const unsigned char* inputData2, int inputCount)
+{
+    long difference = 0;
+    int db, dg, dr;
+    for (int i = 0; i < 4*inputCount; i += 4) {
+        db = inputData1[i] - inputData2[i];
+        dg = inputData1[i+1] - inputData2[i+1];
+        dr = inputData1[i+2] - inputData2[i+2];
+        difference += sqrt(dr*dr + dg*dg + db*db);
+    }
+    return difference;
+}
+
+static void sum_scalar(const unsigned char* inputData, int inputWidth, int inputHeight, int inputStride, long* outputSums)
+{
+    long sum_0 = 0, sum_1 = 0, sum_2 = 0;
+    for (int y = 0; y < inputHeight; y++) {
+        const unsigned char* tempRow = inputData + y*inputStride;
+        for (int i = 0; i < inputWidth; i++) {
+            sum_0 += tempRow[0];
+            sum_1 += tempRow[1];
+            sum_2 += tempRow[2];
+            tempRow += 4;
+        }
+    }
+    outputSums[0] += sum_0;
+    outputSums[1] += sum_1;
+    outputSums[2] += sum_2;
+}
+
+
+//
+// SSE2 kernels
+//
+
+#ifdef __SSE2__
+
+// Squared distances of 4 pixels are at most 3*255^2, which single precision
+// floats hold exactly; their rounded square root never crosses an integer
+// (those are at least 1/900 away), so truncating it matches the scalar code
+static long distance_sse2(const unsigned char* inputData1, const unsigned char* inputData2, int inputCount)
+{
+    const __m128i tempZero = _mm_setzero_si128();
+    const __m128i tempMask = _mm_set1_epi32(0x00FFFFFF);
+    __m128i tempTotal = tempZero;
+    int i = 0;
+    for (; i+4 <= inputCount; i += 4) {
+        __m128i tempPixels1 = _mm_and_si128(_mm_loadu_si128((const __m128i*) (inputData1 + 4*i)), tempMask);
+        __m128i tempPixels2 = _mm_and_si128(_mm_loadu_si128((const __m128i*) (inputData2 + 4*i)), tempMask);
+        __m128i tempLow = _mm_sub_epi16(_mm_unpacklo_epi8(tempPixels1, tempZero), _mm_unpacklo_epi8(tempPixels2, tempZero));
+        __m128i tempHigh = _mm_sub_epi16(_mm_unpackhi_epi8(tempPixels1, tempZero), _mm_unpackhi_epi8(tempPixels2, tempZero));
+
+        // Square and add the channels: every pixel yields b^2+g^2 and r^2
+        __m128 tempSquaresLow = _mm_castsi128_ps(_mm_madd_epi16(tempLow, tempLow));
+        __m128 tempSquaresHigh = _mm_castsi128_ps(_mm_madd_epi16(tempHigh, tempHigh));
+        __m128i tempSquares = _mm_add_epi32(
+            _mm_castps_si128(_mm_shuffle_ps(tempSquaresLow, tempSquaresHigh, _MM_SHUFFLE(2, 0, 2, 0))),
+            _mm_castps_si128(_mm_shuffle_ps(tempSquaresLow, tempSquaresHigh, _MM_SHUFFLE(3, 1, 3, 1))));
+
+        tempTotal = _mm_add_epi32(tempTotal, _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(tempSquares))));
+    }
+
+    int tempLanes[4];
+    _mm_storeu_si128((__m128i*) tempLanes, tempTotal);
+    long difference = (long) tempLanes[0] + tempLanes[1] + tempLanes[2] + tempLanes[3];
+    return difference + distance_scalar(inputData1 + 4*i, inputData2 + 4*i, inputCount - i);
+}
+
+// Every channel gets isolated with a mask, after which SAD against zero
+// adds up its bytes in two 64-bit lanes (which only get added together
+// after the last row)
+static void sum_sse2(const unsigned char* inputData, int inputWidth, int inputHeight, int inputStride, long* outputSums)
+{
+    const __m128i tempZero = _mm_setzero_si128();
+    const __m128i tempMask[3] = {_mm_set1_epi32(0x000000FF), _mm_set1_epi32(0x0000FF00), _mm_set1_epi32(0x00FF0000)};
+    __m128i tempSums[3] = {tempZero, tempZero, tempZero};
+    int tempVector = inputWidth & ~3;
+    for (int y = 0; y < inputHeight; y++) {
+        const unsigned char* tempRow = inputData + y*inputStride;
+        for (int i = 0; i < tempVector; i += 4) {
+            __m128i tempPixels = _mm_loadu_si128((const __m128i*) (tempRow + 4*i));
+            for (int c = 0; c < 3; c++)
+                tempSums[c] = _mm_add_epi64(tempSums[c], _mm_sad_epu8(_mm_and_si128(tempPixels, tempMask[c]), tempZero));
+        }
+    }
+
+    long long tempLanes[2];
+    for (int c = 0; c < 3; c++) {
+        _mm_storeu_si128((__m128i*) tempLanes, tempSums[c]);
+        outputSums[c] += tempLanes[0] + tempLanes[1];
+    }
+    sum_scalar(inputData + 4*tempVector, inputWidth - tempVector, inputHeight, inputStride, outputSums);
+}
+
+#endif
+
+
+//
+// AVX2 kernels
+//
+
+#ifdef KERNELS_AVX2
+
+// Same as the SSE2 kernel, with 8 pixels at a time (the unpacks and
+// shuffles work per 128-bit lane, which keeps the pixels together); the
+// upper halves of the registers get cleared explicitly before handing the
+// remainder to the scalar kernel, as the compiler omits that on tail calls
+// and the SSE code running afterwards would stall on every call
+__attribute__((target("avx2")))
+static long distance_avx2(const unsigned char* inputData1, const unsigned char* inputData2, int inputCount)
+{
+    const __m256i tempZero = _mm256_setzero_si256();
+    const __m256i tempMask = _mm256_set1_epi32(0x00FFFFFF);
+    __m256i tempTotal = tempZero;
+    int i = 0;
+    for (; i+8 <= inputCount; i += 8) {
+        __m256i tempPixels1 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (inputData1 + 4*i)), tempMask);
+        __m256i tempPixels2 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (inputData2 + 4*i)), tempMask);
+        __m256i tempLow = _mm256_sub_epi16(_mm256_unpacklo_epi8(tempPixels1, tempZero), _mm256_unpacklo_epi8(tempPixels2, tempZero));
+        __m256i tempHigh = _mm256_sub_epi16(_mm256_unpackhi_epi8(tempPixels1, tempZero), _mm256_unpackhi_epi8(tempPixels2, tempZero));
+
+        __m256 tempSquaresLow = _mm256_castsi256_ps(_mm256_madd_epi16(tempLow, tempLow));
+        __m256 tempSquaresHigh = _mm256_castsi256_ps(_mm256_madd_epi16(tempHigh, tempHigh));
+        __m256i tempSquares = _mm256_add_epi32(
+            _mm256_castps_si256(_mm256_shuffle_ps(tempSquaresLow, tempSquaresHigh, _MM_SHUFFLE(2, 0, 2, 0))),
+            _mm256_castps_si256(_mm256_shuffle_ps(tempSquaresLow, tempSquaresHigh, _MM_SHUFFLE(3, 1, 3, 1))));
+
+        tempTotal = _mm256_add_epi32(tempTotal, _mm256_cvttps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(tempSquares))));
+    }
+
+    int tempLanes[8];
+    _mm256_storeu_si256((__m256i*) tempLanes, tempTotal);
+    long difference = 0;
+    for (int l = 0; l < 8; l++)
+        difference += tempLanes[l];
+    _mm256_zeroupper();
+    return difference + distance_scalar(inputData1 + 4*i, inputData2 + 4*i, inputCount - i);
+}
+
+__attribute__((target("avx2")))
+static void sum_avx2(const unsigned char* inputData, int inputWidth, int inputHeight, int inputStride, long* outputSums)
+{
+    const __m256i tempZero = _mm256_setzero_si256();
+    const __m256i tempMask[3] = {_mm256_set1_epi32(0x000000FF), _mm256_set1_epi32(0x0000FF00), _mm256_set1_epi32(0x00FF0000)};
+    __m256i tempSums[3] = {tempZero, tempZero, tempZero};
+    int tempVector = inputWidth & ~7;
+    for (int y = 0; y < inputHeight; y++) {
+        const unsigned char* tempRow = inputData + y*inputStride;
+        for (int i = 0; i < tempVector; i += 8) {
+            __m256i tempPixels = _mm256_loadu_si256((const __m256i*) (tempRow + 4*i));
+            for (int c = 0; c < 3; c++)
+                tempSums[c] = _mm256_add_epi64(tempSums[c], _mm256_sad_epu8(_mm256_and_si256(tempPixels, tempMask[c]), tempZero));
+        }
+    }
+
+    long long tempLanes[4];
+    for (int c = 0; c < 3; c++) {
+        _mm256_storeu_si256((__m256i*) tempLanes, tempSums[c]);
+        outputSums[c] += tempLanes[0] + tempLanes[1] + tempLanes[2] + tempLanes[3];
+    }
+    _mm256_zeroupper();
+    sum_scalar(inputData + 4*tempVector, inputWidth - tempVector, inputHeight, inputStride, outputSums);
+}
+
+#endif
+
+
+//
+// Implementation selection
+//
+
+// Check whether an implementation has been compiled in, and can run here
+bool kernel_supported(KERNEL inputKernel)
+{
+    switch (inputKernel) {
+        case KERNEL_SCALAR:
+            return true;
+        case KERNEL_SSE2:
+#ifdef __SSE2__
+            return true;
+#else
+            return false;
+#endif
+        case KERNEL_AVX2:
+#ifdef KERNELS_AVX2
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Get the fastest supported implementation
+KERNEL kernel_best()
+{
+    if (kernel_supported(KERNEL_AVX2))
+        return KERNEL_AVX2;
+    if (kernel_supported(KERNEL_SSE2))
+        return KERNEL_SSE2;
+    return KERNEL_SCALAR;
+}
+
+// Currently used implementation
+static KERNEL KERNEL_SELECTED = kernel_best();
+
+// Use another implementation (if supported)
+bool kernel_select(KERNEL inputKernel)
+{
+    if (!kernel_supported(inputKernel))
+        return false;
+    KERNEL_SELECTED = inputKernel;
+    return true;
+}
+
+KERNEL kernel_selected()
+{
+    return KERNEL_SELECTED;
+}
+
+
+//
+// Kernels
+//
+
+// Sum of the euclidian colour distances between two pixel runs, every one
+// of which gets truncated
+long kernel_distance(const unsigned char* inputData1, const unsigned char* inputData2, int inputCount)
+{
+    switch (KERNEL_SELECTED) {
+#ifdef KERNELS_AVX2
+        case KERNEL_AVX2:
+            return distance_avx2(inputData1, inputData2, inputCount);
+#endif
+#ifdef __SSE2__
+        case KERNEL_SSE2:
+            return distance_sse2(inputData1, inputData2, inputCount);
+#endif
+        default:
+            return distance_scalar(inputData1, inputData2, inputCount);
+    }
+}
+
+// Add the sums of the first three channels of a pixel run to outputSums
+void kernel_sum(const unsigned char* inputData, int inputCount, long* outputSums)
+{
+    kernel_sum(inputData, inputCount, 1, 0, outputSums);
+}
+
+// Add the sums of the first three channels of a rectangle of pixels (with
+// rows inputStride bytes apart) to outputSums
+void kernel_sum(const unsigned char* inputData, int inputWidth, int inputHeight, int inputStride, long* outputSums)
+{
+    switch (KERNEL_SELECTED) {
+#ifdef KERNELS_AVX2
+        case KERNEL_AVX2:
+            sum_avx2(inputData, inputWidth, inputHeight, inputStride, outputSums);
+            break;
+#endif
+#ifdef __SSE2__
+        case KERNEL_SSE2:
+            sum_sse2(inputData, inputWidth, inputHeight, inputStride, outputSums);
+            break;
+#endif
+        default:
+            sum_scalar(inputData, inputWidth, inputHeight, inputStride, outputSums);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * kernels.h
+ * Evolve - Image generating environment (comparison kernels)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * The pixel loops of both comparison methods, on runs of RGB24 pixels (4
+ * bytes each, of which the last one is ignored). Every kernel has a scalar
+ * implementation, and vectorised SSE2 and AVX2 ones which produce exactly
+ * the same results; the fastest one the processor supports gets selected
+ * at startup.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __KERNELS
+#define __KERNELS
+
+
+//
+// Constants
+//
+
+// Kernel implementations
+enum KERNEL {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+};
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+// Implementation selection
+bool kernel_supported(KERNEL inputKernel);
+KERNEL kernel_best();
+bool kernel_select(KERNEL inputKernel);
+KERNEL kernel_selected();
+
+// Sum of the (truncated) euclidian colour distances between two pixel runs
+long kernel_distance(const unsigned char* inputData1, const unsigned char* inputData2, int inputCount);
+
+// Add the sums of the first three channels of a pixel run, or of a
+// rectangle of pixels, to outputSums
+void kernel_sum(const unsigned char* inputData, int inputCount, long* outputSums);
+void kernel_sum(const unsigned char* inputData, int inputWidth, int inputHeight, int inputStride, long* outputSums);
+
+
+// Include guard
+#endif
@@ -0,0 +1,245 @@
+/*
+ * raster.cpp
+ * Evolve - Image generating environment (scanline rasteriser)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "raster.h"
+#include <algorithm>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+// Integer division, rounding upwards or downwards (for a positive divisor)
+static inline long ceil_divide(long inputNumerator, long inputDenominator)
+{
+    return inputNumerator >= 0 ? (inputNumerator + inputDenominator - 1) / inputDenominator
+                               : -(-inputNumerator / inputDenominator);
+}
+static inline long floor_divide(long inputNumerator, long inputDenominator)
+{
+    return -ceil_divide(-inputNumerator, inputDenominator);
+}
+
+// Blend a span of RGB24 pixels with a colour
+//   every channel becomes (pixel*inverse + colour*alpha) / 255, in which the
+//   colour has been premultiplied and biased with 128 for rounding; the
+//   division uses (t + t>>8) >> 8, which stays within 16 bits
+static void blend_span(unsigned char* inputPixels, int inputCount, const unsigned short* inputColour, unsigned short inputInverse)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i tempZero = _mm_setzero_si128();
+    const __m128i tempColour = _mm_setr_epi16(inputColour[0], inputColour[1], inputColour[2], inputColour[3],
+                                              inputColour[0], inputColour[1], inputColour[2], inputColour[3]);
+    const __m128i tempInverse = _mm_set1_epi16(inputInverse);
+    for (; i+4 <= inputCount; i += 4) {
+        __m128i tempPixels = _mm_loadu_si128((const __m128i*) (inputPixels + 4*i));
+        __m128i tempLow = _mm_unpacklo_epi8(tempPixels, tempZero);
+        __m128i tempHigh = _mm_unpackhi_epi8(tempPixels, tempZero);
+        tempLow = _mm_add_epi16(_mm_mullo_epi16(tempLow, tempInverse), tempColour);
+        tempHigh = _mm_add_epi16(_mm_mullo_epi16(tempHigh, tempInverse), tempColour);
+        tempLow = _mm_srli_epi16(_mm_add_epi16(tempLow, _mm_srli_epi16(tempLow, 8)), 8);
+        tempHigh = _mm_srli_epi16(_mm_add_epi16(tempHigh, _mm_srli_epi16(tempHigh, 8)), 8);
+        _mm_storeu_si128((__m128i*) (inputPixels + 4*i), _mm_packus_epi16(tempLow, tempHigh));
+    }
+#endif
+    for (unsigned char* tempPixel = inputPixels + 4*i; i < inputCount; i++) {
+        for (int c = 0; c < 4; c++) {
+            unsigned int t = *tempPixel * inputInverse + inputColour[c];
+            *(tempPixel++) = (t + (t >> 8)) >> 8;
+        }
+    }
+}
+
+// Fill a span of RGB24 pixels with an opaque colour
+static void fill_span(unsigned char* inputPixels, int inputCount, const unsigned char* inputPixel)
+{
+    int i = 0;
+#ifdef __SSE2__
+    int tempValue;
+    std::memcpy(&tempValue, inputPixel, 4);
+    const __m128i tempPixels = _mm_set1_epi32(tempValue);
+    for (; i+4 <= inputCount; i += 4)
+        _mm_storeu_si128((__m128i*) (inputPixels + 4*i), tempPixels);
+#endif
+    for (; i < inputCount; i++)
+        std::memcpy(inputPixels + 4*i, inputPixel, 4);
+}
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Construction and destruction
+//
+
+// Default constructor
+Raster::Raster()
+{
+    dataData = 0;
+    dataWidth = 0;
+    dataHeight = 0;
+    dataStride = 0;
+    dataClip.left = dataClip.top = dataClip.right = dataClip.bottom = 0;
+}
+
+
+//
+// Target buffer
+//
+
+// Set the pixel buffer to draw on (which resets the clip region)
+void Raster::setTarget(unsigned char* inputData, int inputWidth, int inputHeight, int inputStride)
+{
+    dataData = inputData;
+    dataWidth = inputWidth;
+    dataHeight = inputHeight;
+    dataStride = inputStride;
+
+    dataClip.left = dataClip.top = 0;
+    dataClip.right = inputWidth;
+    dataClip.bottom = inputHeight;
+}
+
+// Restrict drawing to a region of the target
+void Raster::setClip(const region& inputClip)
+{
+    dataClip.left = std::max(inputClip.left, 0);
+    dataClip.top = std::max(inputClip.top, 0);
+    dataClip.right = std::min(inputClip.right, dataWidth);
+    dataClip.bottom = std::min(inputClip.bottom, dataHeight);
+}
+
+
+//
+// Drawing
+//
+
+// Fill a polygon
+//   the vertices have integer coordinates, so pixel centres (at half
+//   coordinates) never coincide with a vertex row, and every scanline
+//   crosses the outline an even amount of times. The first pixel right of
+//   a crossing at x is ceil(x - 1/2), which every edge tracks exactly as a
+//   fraction with twice the edge height as denominator, stepping it from
+//   row to row without divisions.
+void Raster::fill(const vertex* inputPoints, unsigned int inputCount, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    if (dataData == 0 || inputCount < 3 || a == 0)
+        return;
+
+    // Vertical extent, clipped
+    int tempTop = inputPoints[0].y, tempBottom = inputPoints[0].y;
+    for (unsigned int i = 1; i < inputCount; i++) {
+        tempTop = std::min(tempTop, inputPoints[i].y);
+        tempBottom = std::max(tempBottom, inputPoints[i].y);
+    }
+    tempTop = std::max(tempTop, dataClip.top);
+    tempBottom = std::min(tempBottom, dataClip.bottom);
+
+    // Collect the non-horizontal edges, positioned at their first visible row
+    dataEdges.resize(inputCount);
+    unsigned int tempEdges = 0;
+    for (unsigned int i = 0, j = inputCount-1; i < inputCount; j = i++) {
+        const vertex& p0 = inputPoints[j].y < inputPoints[i].y ? inputPoints[j] : inputPoints[i];
+        const vertex& p1 = inputPoints[j].y < inputPoints[i].y ? inputPoints[i] : inputPoints[j];
+        if (p0.y == p1.y || p1.y <= tempTop || p0.y >= tempBottom)
+            continue;
+
+        // The crossing at row y is ceil(N/D), with N = (2*x0-1)*h + (2*(y-y0)+1)*dx
+        // and D = 2*h; keep it as x - remainder/D, with 0 <= remainder < D
+        Edge& tempEdge = dataEdges[tempEdges++];
+        long tempHeight = p1.y - p0.y, tempWidth = p1.x - p0.x;
+        tempEdge.top = std::max(p0.y, tempTop);
+        tempEdge.bottom = p1.y;
+        tempEdge.denominator = 2 * tempHeight;
+        long tempNumerator = (2L*p0.x - 1) * tempHeight + (2L*(tempEdge.top - p0.y) + 1) * tempWidth;
+        tempEdge.x = ceil_divide(tempNumerator, tempEdge.denominator);
+        tempEdge.remainder = tempEdge.x * tempEdge.denominator - tempNumerator;
+
+        // Split the step per row (2*dx) in a whole and a fractional part
+        long tempStep = 2 * tempWidth;
+        tempEdge.step = floor_divide(tempStep, tempEdge.denominator);
+        tempEdge.fraction = tempStep - tempEdge.step * tempEdge.denominator;
+    }
+
+    // Prepare the colour (in the BGRX memory order of RGB24)
+    unsigned char tempPixel[4] = {b, g, r, 0xFF};
+    unsigned short tempColour[4];
+    unsigned short tempInverse = 255 - a;
+    for (int c = 0; c < 4; c++)
+        tempColour[c] = tempPixel[c] * a + 128;
+
+    // Process all scanlines
+    dataCrossings.resize(tempEdges);
+    for (int y = tempTop; y < tempBottom; y++) {
+        // Find all crossings with the outline, in increasing order, and
+        // advance the edges to the next row
+        unsigned int tempCrossings = 0;
+        for (unsigned int i = 0; i < tempEdges; i++) {
+            Edge& tempEdge = dataEdges[i];
+            if (y < tempEdge.top || y >= tempEdge.bottom)
+                continue;
+            int tempX = tempEdge.x;
+            unsigned int j = tempCrossings++;
+            for (; j > 0 && dataCrossings[j-1] > tempX; j--)
+                dataCrossings[j] = dataCrossings[j-1];
+            dataCrossings[j] = tempX;
+
+            tempEdge.x += tempEdge.step;
+            tempEdge.remainder -= tempEdge.fraction;
+            if (tempEdge.remainder < 0) {
+                tempEdge.x++;
+                tempEdge.remainder += tempEdge.denominator;
+            }
+        }
+
+        // Fill the spans between pairs of crossings
+        unsigned char* tempRow = dataData + y*dataStride;
+        for (unsigned int i = 0; i+1 < tempCrossings; i += 2) {
+            int tempStart = std::max(dataCrossings[i], dataClip.left);
+            int tempEnd = std::min(dataCrossings[i+1], dataClip.right);
+            if (tempStart >= tempEnd)
+                continue;
+            if (a == 255)
+                fill_span(tempRow + 4*tempStart, tempEnd - tempStart, tempPixel);
+            else
+                blend_span(tempRow + 4*tempStart, tempEnd - tempStart, tempColour, tempInverse);
+        }
+    }
+}
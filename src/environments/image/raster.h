@@ -0,0 +1,98 @@
+/*
+ * raster.h
+ * Evolve - Image generating environment (scanline rasteriser)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __RASTER
+#define __RASTER
+
+// Headers
+#include <vector>
+
+
+//
+// Additional structures
+//
+
+struct vertex {
+    int x;
+    int y;
+    bool drawn;
+    double angle;
+};
+
+// Rectangular pixel region (right and bottom exclusive)
+struct region {
+    int left, top;
+    int right, bottom;
+};
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Scanline rasteriser
+//   fills simple polygons onto an RGB24 pixel buffer, without anti-aliasing:
+//   a pixel gets covered when its centre lies inside the polygon (even-odd
+//   rule). Spans are alpha blended with SSE2 when available, four pixels at
+//   a time, and written directly when the colour is opaque.
+class Raster
+{
+    public:
+        // Construction and destruction
+        Raster();
+
+        // Target buffer
+        void setTarget(unsigned char* inputData, int inputWidth, int inputHeight, int inputStride);
+        void setClip(const region& inputClip);
+
+        // Drawing
+        void fill(const vertex* inputPoints, unsigned int inputCount, unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+
+    private:
+        // Polygon edge, directed downwards
+        struct Edge {
+            int top, bottom;                // first row, and the row past the last one
+            long x, remainder, denominator; // first pixel right of the edge: x - remainder/denominator
+            long step, fraction;            // increment per row: step + fraction/denominator
+        };
+
+        // Member data
+        unsigned char* dataData;
+        int dataWidth, dataHeight, dataStride;
+        region dataClip;
+        std::vector<Edge> dataEdges;
+        std::vector<int> dataCrossings;
+};
+
+
+// Include guard
+#endif
@@ -0,0 +1,120 @@
+/*
+ * launcher.cpp
+ * Evolve - Launcher running several processes as islands
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "../migration.h"
+#include "../generic.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+//
+// Constants
+//
+
+// Interval at which the coordinator checks for finished islands (in ms)
+const int LAUNCHER_INTERVAL = 100;
+
+
+
+//////////
+// MAIN //
+//////////
+
+// Usage: launcher ISLANDS TOPOLOGY COMMAND [ARGUMENTS...]
+//   runs COMMAND in ISLANDS processes, which share the processors and
+//   exchange their elites through a coordinator in this process
+int main(int argc, char** argv) {
+    // Check input
+    if (argc < 4) {
+        std::cout << "ERROR: usage is " << argv[0] << " ISLANDS ring|full|random COMMAND [ARGUMENTS...]" << std::endl;
+        return 1;
+    }
+    int inputIslands = atoi(argv[1]);
+    if (inputIslands < 1) {
+        std::cout << "ERROR: invalid amount of islands" << std::endl;
+        return 1;
+    }
+    TOPOLOGY inputTopology;
+    std::string tempTopology = argv[2];
+    if (tempTopology == "ring")
+        inputTopology = TOPOLOGY_RING;
+    else if (tempTopology == "full")
+        inputTopology = TOPOLOGY_FULL;
+    else if (tempTopology == "random")
+        inputTopology = TOPOLOGY_RANDOM;
+    else {
+        std::cout << "ERROR: unknown topology '" << tempTopology << "'" << std::endl;
+        return 1;
+    }
+
+    // Start the coordinator
+    MigCoordinator tempCoordinator(inputTopology);
+    std::string tempPath = "/tmp/evolve-" + stringify(getpid()) + ".socket";
+    if (!tempCoordinator.listen(tempPath)) {
+        std::cout << "ERROR: could not listen on " << tempPath << std::endl;
+        return 1;
+    }
+    std::cout << "NOTE: coordinator listening on " << tempPath << std::endl;
+
+    // Start the islands
+    unsigned int tempThreads = std::max(std::thread::hardware_concurrency() / inputIslands, 1u);
+    setenv(MIGRATION_SOCKET, tempPath.c_str(), 1);
+    setenv(MIGRATION_THREADS, stringify(tempThreads).c_str(), 1);
+    int tempRunning = 0;
+    for (int i = 0; i < inputIslands; i++) {
+        pid_t tempProcess = fork();
+        if (tempProcess == -1) {
+            std::cout << "ERROR: could not start island " << i << std::endl;
+            break;
+        }
+        if (tempProcess == 0) {
+            setenv(MIGRATION_ISLAND, stringify(i).c_str(), 1);
+            execvp(argv[3], argv + 3);
+            std::cout << "ERROR: could not execute " << argv[3] << std::endl;
+            _exit(1);
+        }
+        tempRunning++;
+    }
+    std::cout << "NOTE: started " << tempRunning << " islands, with " << tempThreads << " threads each" << std::endl;
+
+    // Relay migrants until all islands have finished
+    while (tempRunning > 0) {
+        tempCoordinator.relay(LAUNCHER_INTERVAL);
+        while (waitpid(-1, 0, WNOHANG) > 0)
+            tempRunning--;
+    }
+    std::cout << "NOTE: all islands finished, best fitness relayed was " << 100 * tempCoordinator.fitness() << " points" << std::endl;
+
+    return 0;
+}
@@ -69,9 +69,8 @@ Init the board blocks with free positions
 void Board::InitBoard()
 {
         mScore = 0;
-	for (int i = 0; i < BOARD_WIDTH; i++)
-		for (int j = 0; j < BOARD_HEIGHT; j++)
-			mBoard[i][j] = POS_FREE;
+	for (int j = 0; j < BOARD_HEIGHT; j++)
+		mBoard[j] = ROW_WALLS;
 }
 
 /* 
@@ -88,15 +87,14 @@ Parameters:
 */
 void Board::StorePiece (int pX, int pY, int pPiece, int pRotation)
 {
-	// Store each block of the piece into the board
-	for (int i1 = pX, i2 = 0; i1 < pX + PIECE_BLOCKS; i1++, i2++)
+	// Store each row of the piece into the board (blocks outside of the board are dropped)
+	int mShift = pX + BOARD_PADDING;
+	if (mShift < 0 || mShift + PIECE_BLOCKS > 32)
+		return;
+	for (int j1 = pY, j2 = 0; j1 < pY + PIECE_BLOCKS; j1++, j2++)
 	{
-		for (int j1 = pY, j2 = 0; j1 < pY + PIECE_BLOCKS; j1++, j2++)
-		{	
-			// Store only the blocks of the piece that are not holes
-			if (mPieces->GetBlockType (pPiece, pRotation, j2, i2) != 0)		
-				mBoard[i1][j1] = POS_FILLED;	
-		}
+		if (j1 >= 0 && j1 < BOARD_HEIGHT)
+			mBoard[j1] |= (mPieces->GetRowMask (pPiece, pRotation, j2) << mShift) & ROW_BOARD;
 	}
 }
 
@@ -111,12 +109,7 @@ Returns true or false
 bool Board::IsGameOver()
 {
 	//If the first line has blocks, then, game over
-	for (int i = 0; i < BOARD_WIDTH; i++)
-	{
-		if (mBoard[i][0] == POS_FILLED) return true;
-	}
-
-	return false;
+	return (mBoard[0] & ROW_BOARD) != 0;
 }
 
 
@@ -134,10 +127,7 @@ void Board::DeleteLine (int pY)
 	// Moves all the upper lines one row down
 	for (int j = pY; j > 0; j--)
 	{
-		for (int i = 0; i < BOARD_WIDTH; i++)
-		{
-			mBoard[i][j] = mBoard[i][j-1];
-		}
+		mBoard[j] = mBoard[j-1];
 	}	
 }
 
@@ -151,14 +141,7 @@ void Board::DeletePossibleLines ()
 {
 	for (int j = 0; j < BOARD_HEIGHT; j++)
 	{
-		int i = 0;
-		while (i < BOARD_WIDTH)
-		{
-			if (mBoard[i][j] != POS_FILLED) break;
-			i++;
-		}
-
-		if (i == BOARD_WIDTH) {
+		if (mBoard[j] == ROW_FULL) {
                     DeleteLine (j);
                     mScore += 100;
                 }
@@ -178,7 +161,7 @@ Parameters:
 */
 bool Board::IsFreeBlock (int pX, int pY)
 {
-	if (mBoard [pX][pY] == POS_FREE) return true; else return false;
+	return (mBoard [pY] & (1u << (pX + BOARD_PADDING))) == 0;
 }
 
 
@@ -228,28 +211,25 @@ Parameters:
 bool Board::IsPossibleMovement (int pX, int pY, int pPiece, int pRotation)
 {
 	// Checks collision with pieces already stored in the board or the board limits
-	// This is just to check the 5x5 blocks of a piece with the appropiate area in the board
-	for (int i1 = pX, i2 = 0; i1 < pX + PIECE_BLOCKS; i1++, i2++)
+	// Every row of the piece is shifted into place, and tested against the bitboard row,
+	// which has its wall bits set
+	int mShift = pX + BOARD_PADDING;
+	if (mShift < 0 || mShift + PIECE_BLOCKS > 32)
+		return false;
+	for (int j1 = pY, j2 = 0; j1 < pY + PIECE_BLOCKS; j1++, j2++)
 	{
-		for (int j1 = pY, j2 = 0; j1 < pY + PIECE_BLOCKS; j1++, j2++)
-		{	
-			// Check if the piece is outside the limits of the board
-			if (	i1 < 0 			|| 
-				i1 > BOARD_WIDTH  - 1	||
-				j1 > BOARD_HEIGHT - 1)
-			{
-				if (mPieces->GetBlockType (pPiece, pRotation, j2, i2) != 0)
-					return 0;		
-			}
-
-			// Check if the piece have collisioned with a block already stored in the map
-			if (j1 >= 0)	
-			{
-				if ((mPieces->GetBlockType (pPiece, pRotation, j2, i2) != 0) &&
-					(!IsFreeBlock (i1, j1))	)
-					return false;
-			}
-		}
+		uint32_t mRow = mPieces->GetRowMask (pPiece, pRotation, j2);
+		if (mRow == 0)
+			continue;
+
+		// Check if the piece is below the board
+		if (j1 > BOARD_HEIGHT - 1)
+			return false;
+
+		// Check for collisions (above the board, only the walls count)
+		uint32_t mLine = (j1 >= 0) ? mBoard[j1] : ROW_WALLS;
+		if ((mLine & (mRow << mShift)) != 0)
+			return false;
 	}
 
 	// No collision
@@ -48,6 +48,12 @@
 #define MIN_VERTICAL_MARGIN 20		// Minimum vertical margin for the board limit 		
 #define MIN_HORIZONTAL_MARGIN 20	// Minimum horizontal margin for the board limit
 #define PIECE_BLOCKS 5				// Number of horizontal and vertical blocks of a matrix piece
+#define BOARD_PADDING PIECE_BLOCKS	// Amount of wall blocks at the left of every row
+
+// Bitboard rows: board blocks are stored from bit BOARD_PADDING onwards, all other bits are walls
+const uint32_t ROW_BOARD = ((1u << BOARD_WIDTH) - 1) << BOARD_PADDING;
+const uint32_t ROW_WALLS = ~ROW_BOARD;
+const uint32_t ROW_FULL = ~0u;
 
 
 
@@ -72,8 +78,7 @@ class Board {
 
 	private:
                 unsigned long mScore;
-		enum { POS_FREE, POS_FILLED };			// POS_FREE = free position of the board; POS_FILLED = filled position of the board
-		int mBoard [BOARD_WIDTH][BOARD_HEIGHT];	// Board that contains the pieces
+		uint32_t mBoard [BOARD_HEIGHT];			// Board that contains the pieces, one bitmask per row
 		Pieces *mPieces;
 		int mScreenHeight;
 
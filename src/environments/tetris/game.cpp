@@ -92,14 +92,11 @@ void Game::Reset() {
 
 // Get a random integer from pA to pB (inclusive)
 int Game::GetRand (int pA, int pB) {
-	return rand () % (pB - pA + 1) + pA;
+	return random_int (pA, pB + 1);
 }
 
 // Initialise the game parameters
 void Game::InitGame() {
-	// Init random numbers
-	srand ((unsigned int) time(NULL));
-
 	// First piece
 	mPiece			= GetRand (0, 6);
 	mRotation		= GetRand (0, 3);
@@ -210,6 +207,9 @@ Draw all the objects of the scene
 */
 void Game::DrawScene ()
 {
+	// Headless games don't draw
+	if (mOutput == NULL)
+		return;
 
 	mOutput->ClearScreen (); 		// Clear screen		
 	DrawBoard ();													// Draw the delimitation lines and blocks stored in the board
@@ -37,7 +37,7 @@
 #include "input.h"
 #include "board.h"
 #include "pieces.h"
-#include <time.h>
+#include "../../generic.h"
 
 
 //
@@ -55,6 +55,7 @@
 class Game {
 	public:
 		// Construction and destruction
+		//   pOutput can be NULL, in which case nothing gets drawn
 		Game(Board *pBoard, Pieces *pPieces, Output *pOutput, int pScreenHeight);
 		
 		// Game routines
@@ -322,12 +322,49 @@ int mPiecesInitialPosition  [7 /*kind */ ][4 /* rotation */ ][2 /* position */]
 // CLASS IMPLEMENTATION //
 //////////////////////////
 
+/* 
+======================================									
+Precompute the row masks of all pieces
+====================================== 
+*/
+Pieces::Pieces ()
+{
+	for (int p = 0; p < 7; p++)
+		for (int r = 0; r < 4; r++)
+			for (int y = 0; y < 5; y++)
+			{
+				mRowMasks[p][r][y] = 0;
+				for (int x = 0; x < 5; x++)
+					if (mPieces[p][r][y][x] != 0)
+						mRowMasks[p][r][y] |= 1 << x;
+			}
+}
+
+
 int Pieces::GetBlockType (int pPiece, int pRotation, int pX, int pY)
 {
 	return mPieces [pPiece][pRotation][pX][pY];
 }
 
 
+/* 
+======================================									
+Returns the blocks of a row of the piece, as a bitmask where bit i is set if
+the i-th horizontal block is filled
+
+Parameters:
+
+>> pPiece:	Piece to draw
+>> pRotation:	1 of the 4 possible rotations
+>> pY:		Vertical block of the piece
+====================================== 
+*/
+uint32_t Pieces::GetRowMask (int pPiece, int pRotation, int pY)
+{
+	return mRowMasks [pPiece][pRotation][pY];
+}
+
+
 /* 
 ======================================									
 Returns the horizontal displacement of the piece that has to be applied in order to create it in the
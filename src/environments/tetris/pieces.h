@@ -33,6 +33,9 @@
 #ifndef __TETRIS_PIECES
 #define __TETRIS_PIECES
 
+// Headers
+#include <stdint.h>
+
 
 
 //////////////////////
@@ -41,10 +44,15 @@
 
 class Pieces {
 	public:
+		Pieces					();
 
 		int GetBlockType		(int pPiece, int pRotation, int pX, int pY);
+		uint32_t GetRowMask		(int pPiece, int pRotation, int pY);
 		int GetXInitialPosition (int pPiece, int pRotation);
 		int GetYInitialPosition (int pPiece, int pRotation);
+
+	private:
+		uint32_t mRowMasks [7][4][5];	// Filled blocks of every row of a piece (bit i = horizontal block i)
 };
 
 // Include guard
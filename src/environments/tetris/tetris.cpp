@@ -41,18 +41,30 @@
 // Construction and destruction
 //
 
-EnvTetris::EnvTetris() {
+EnvTetris::EnvTetris(bool iHeadless) {
     // Configure grammar and parser
     setup();
     mParser = new Parser(this, LIMIT_INSTRUCTIONS);
 
+    // Configure output
+    int tScreenHeight = GAME_SCREENHEIGHT;
+    if (iHeadless) {
+        mTetrisOutput = NULL;
+    } else {
+        mTetrisOutput = new Output();
+        tScreenHeight = mTetrisOutput->GetScreenHeight();
+    }
+
     // Configure tetris
-    mTetrisBoard = new Board(&mTetrisPieces, mTetrisOutput.GetScreenHeight());
-    mTetrisGame = new Game(mTetrisBoard, &mTetrisPieces, &mTetrisOutput, mTetrisOutput.GetScreenHeight());
+    mTetrisBoard = new Board(&mTetrisPieces, tScreenHeight);
+    mTetrisGame = new Game(mTetrisBoard, &mTetrisPieces, mTetrisOutput, tScreenHeight);
 }
 
 EnvTetris::~EnvTetris() {
     delete(mParser);
+    delete(mTetrisGame);
+    delete(mTetrisBoard);
+    delete(mTetrisOutput);
 }
 
 
@@ -69,12 +81,11 @@ int EnvTetris::alphabet() const {
 
 // Fitness function
 double EnvTetris::fitness(const DNA* inputDNA) {
-    // Validate the syntax
-    try {
-        mParser->validate(*inputDNA);
-    } catch (Exception e) {
+    // Validate and compile the code
+    Program tProgram;
+    Error tError;
+    if (!mParser->compile(*inputDNA, tProgram, tError))
         return 0;
-    }
 
     // Reset tetris
     mTetrisGame->Reset();
@@ -82,18 +93,19 @@ double EnvTetris::fitness(const DNA* inputDNA) {
     // Execute the code
     double tScore = 0;
     unsigned long tScoreCurrent;
-    try {
-        for (unsigned int i = 0; i < RUNS; i++) {
-
-            // Reset counters and gamestate
-            unsigned long tCountUnchanged = 0;
-            unsigned int tScorePrevious = 0;
-            unsigned long tTime1 = SDL_GetTicks();
-            mTetrisGame->Reset();
-
-            // Play a game
-            while (!mTetrisBoard->IsGameOver() && tCountUnchanged <= LIMIT_RUNS) {
-                // Poll for events
+    for (unsigned int i = 0; i < RUNS; i++) {
+
+        // Reset counters and gamestate
+        unsigned long tCountUnchanged = 0;
+        unsigned int tScorePrevious = 0;
+        unsigned long tTicks = 0;
+        unsigned long tTime1 = (mTetrisOutput != NULL) ? SDL_GetTicks() : 0;
+        mTetrisGame->Reset();
+
+        // Play a game
+        while (!mTetrisBoard->IsGameOver() && tCountUnchanged <= LIMIT_RUNS) {
+            // Poll for events
+            if (mTetrisOutput != NULL) {
                 SDL_Event event;
                 while ( SDL_PollEvent(&event) ) {
                         switch (event.type) {
@@ -101,35 +113,45 @@ double EnvTetris::fitness(const DNA* inputDNA) {
                                         exit(3);
                         }
                 }
-                // Evaluate
-                mParser->evaluate(*inputDNA);
-                
-                // Manage counters
+            }
+
+            // Evaluate
+            if (!mParser->execute(tProgram, tError))
+                return 0;
+            
+            // Manage counters
+            if (mTetrisOutput != NULL)
                 SDL_Delay(GAME_USERDELAY/GAME_SPEED);
 
-                // Calculate score
-                tScoreCurrent = mTetrisBoard->Score();
-                if (tScoreCurrent == tScorePrevious)
-                    tCountUnchanged++;
-                tScorePrevious = tScoreCurrent;
-
-		// Move downwards if the wait time is elapsed
-		unsigned long tTime2 = SDL_GetTicks();
-		if ((tTime2 - tTime1) > GAME_DROPDELAY/GAME_SPEED) {
-			mTetrisGame->down();
-                        mTetrisGame->DrawScene();
-			tTime1 = tTime2;
-		}
+            // Calculate score
+            tScoreCurrent = mTetrisBoard->Score();
+            if (tScoreCurrent == tScorePrevious)
+                tCountUnchanged++;
+            tScorePrevious = tScoreCurrent;
+
+            // Move downwards if the wait time is elapsed (in headless
+            // mode, time is measured in evaluations instead)
+            bool tDrop;
+            if (mTetrisOutput != NULL) {
+                unsigned long tTime2 = SDL_GetTicks();
+                tDrop = (tTime2 - tTime1) > GAME_DROPDELAY/GAME_SPEED;
+                if (tDrop)
+                    tTime1 = tTime2;
+            } else {
+                tDrop = (++tTicks % GAME_DROPTICKS) == 0;
+            }
+            if (tDrop) {
+                mTetrisGame->down();
+                mTetrisGame->DrawScene();
             }
         }
-        tScore += ((double)tScoreCurrent) / LIMIT_RUNS;
-    } catch (Exception e) {
-        return 0;
     }
+    tScore += ((double)tScoreCurrent) / LIMIT_RUNS;
 
     // Get the score
     // TODO: genetic multi-parameter support (e.g. positive score, negative time of death)
-    explain(inputDNA);
+    if (mTetrisOutput != NULL)
+        explain(inputDNA);
     return tScore;
 }
 
@@ -142,11 +164,17 @@ bool EnvTetris::condition() {
 void EnvTetris::update(const DNA* inputDNA) {
 }
 
+// Clone the environment (only headless environments can be evaluated concurrently)
+Environment* EnvTetris::clone() const {
+    if (mTetrisOutput != NULL)
+        return 0;
+    return new EnvTetris(true);
+}
+
 // Expain the DNA
 void EnvTetris::explain(const DNA* iDNA) {
     try {
-        mParser->validate(*iDNA);
-        mParser->evaluate(*iDNA);
+        mParser->execute(mParser->compile(*iDNA));
     }
     catch (Exception e) {
         std::cout << "! Initial DNA invalid" << std::endl << e << std::endl;
@@ -164,35 +192,35 @@ void EnvTetris::explain(const DNA* iDNA) {
 //
 
 unsigned char ROTATE;
-Value EnvTetris::rotate(std::vector<Value>) {
+Value EnvTetris::rotate(const Parameters&) {
     mTetrisGame->rotate();
     mTetrisGame->DrawScene();
     return Value();
 }
 
 unsigned char LEFT;
-Value EnvTetris::left(std::vector<Value>) {
+Value EnvTetris::left(const Parameters&) {
     mTetrisGame->left();
     mTetrisGame->DrawScene();
     return Value();
 }
 
 unsigned char RIGHT;
-Value EnvTetris::right(std::vector<Value>) {
+Value EnvTetris::right(const Parameters&) {
     mTetrisGame->right();
     mTetrisGame->DrawScene();
     return Value();
 }
 
 unsigned char DOWN;
-Value EnvTetris::down(std::vector<Value>) {
+Value EnvTetris::down(const Parameters&) {
     mTetrisGame->down();
     mTetrisGame->DrawScene();
     return Value();
 }
 
 unsigned char DROP;
-Value EnvTetris::drop(std::vector<Value>) {
+Value EnvTetris::drop(const Parameters&) {
     mTetrisGame->drop();
     mTetrisGame->DrawScene();
     return Value();
@@ -204,37 +232,37 @@ Value EnvTetris::drop(std::vector<Value>) {
 //
 
 unsigned char BLOCK_CURRENT;
-Value EnvTetris::block_current(std::vector<Value>) {
+Value EnvTetris::block_current(const Parameters&) {
     return mTetrisGame->getPieceCurrent();
 }
 
 unsigned char BLOCK_NEXT;
-Value EnvTetris::block_next(std::vector<Value>) {
+Value EnvTetris::block_next(const Parameters&) {
     return mTetrisGame->getPieceNext();
 }
 
 unsigned char POS_X;
-Value EnvTetris::pos_x(std::vector<Value>) {
+Value EnvTetris::pos_x(const Parameters&) {
     return mTetrisGame->getX();
 }
 
 unsigned char POS_Y;
-Value EnvTetris::pos_y(std::vector<Value>) {
+Value EnvTetris::pos_y(const Parameters&) {
     return mTetrisGame->getY();
 }
 
 unsigned char ROTATION;
-Value EnvTetris::rotation(std::vector<Value>) {
+Value EnvTetris::rotation(const Parameters&) {
     return mTetrisGame->getRotation();
 }
 
 unsigned char SIZE_X;
-Value EnvTetris::size_x(std::vector<Value>) {
+Value EnvTetris::size_x(const Parameters&) {
     return BOARD_WIDTH;
 }
 
 unsigned char SIZE_Y;
-Value EnvTetris::size_y(std::vector<Value>) {
+Value EnvTetris::size_y(const Parameters&) {
     return BOARD_HEIGHT;
 }
 
@@ -245,27 +273,27 @@ Value EnvTetris::size_y(std::vector<Value>) {
 
 
 unsigned char IS_BLOCK;
-Value EnvTetris::is_block(std::vector<Value> p) {
+Value EnvTetris::is_block(const Parameters& p) {
     int x = p[0].getInt();
     if (x < 0 || x >= BOARD_WIDTH)
-        throw Exception(GENERIC, "x-coordinate invalid");
+        return fail(GENERIC, "x-coordinate invalid");
 
     int y = p[1].getInt();
     if (y < 0 || y >= BOARD_HEIGHT)
-        throw Exception(GENERIC, "y-coordinate invalid");
+        return fail(GENERIC, "y-coordinate invalid");
 
     return (!mTetrisBoard->IsFreeBlock(x, y));
 }
 
 unsigned char IS_FREE;
-Value EnvTetris::is_free(std::vector<Value> p) {
+Value EnvTetris::is_free(const Parameters& p) {
     int x = p[0].getInt();
     if (x < 0 || x >= BOARD_WIDTH)
-        throw Exception(GENERIC, "x-coordinate invalid");
+        return fail(GENERIC, "x-coordinate invalid");
 
     int y = p[1].getInt();
     if (y < 0 || y >= BOARD_HEIGHT)
-        throw Exception(GENERIC, "y-coordinate invalid");
+        return fail(GENERIC, "y-coordinate invalid");
 
     return mTetrisBoard->IsFreeBlock(x, y);
 }
@@ -307,31 +335,22 @@ void EnvTetris::block() {
 }
 
 // Save the function locally
-unsigned char EnvTetris::setPointer(Value (EnvTetris::*iPointer)(std::vector<Value>), std::string iName, std::initializer_list<Type> iParameters, Type iReturn) {
+unsigned char EnvTetris::setPointer(Value (EnvTetris::*iPointer)(const Parameters&), std::string iName, std::initializer_list<Type> iParameters, Type iReturn) {
     unsigned char tByte;
     tByte = SimpleGrammar::createFunction(iName, std::vector<Type>(iParameters), iReturn);
-    mPointers[tByte] = iPointer;
+    setHandler(tByte, static_cast<Handler>(iPointer));
     return tByte;
 }
 
-// Execute a function
-Value EnvTetris::executeFunction(unsigned char iByte, const std::vector<Value>& iParameters) {
-    // Have we got a function definition?
-    std::map<unsigned char, Value (EnvTetris::*)(std::vector<Value>)>::iterator it = mPointers.find(iByte);
-    if (it != mPointers.end())
-        return ((this)->*(mPointers[iByte]))(iParameters);
-    else
-        return SimpleGrammar::executeFunction(iByte, iParameters);
-}
-
 
 //////////
 // MAIN //
 //////////
 // TODO: explain, per environment
-int main() {
-    // Create an environment
-    EnvTetris tEnvironment;
+int main(int argc, char** argv) {
+    // Create an environment (headless, unless the games should be shown)
+    bool tDisplay = (argc >= 2 && std::string(argv[1]) == "display");
+    EnvTetris tEnvironment(!tDisplay);
 
     // Set-up an initial DNA string
     std::cout << "* Initial construct" << std::endl;
@@ -363,8 +382,17 @@ int main() {
     tEnvironment.explain(&tDNA);
     
     
-    // Create a population with initial DNA
-    Population* tPopulation = new PopSingleStraight(&tEnvironment, tDNA);
+    // Create a population with initial DNA (an island population, if
+    // started by the launcher)
+    Population* tPopulation;
+    Migration* tMigration = migration_connect();
+    if (tMigration != 0) {
+        PopIsland* tIslands = new PopIsland(&tEnvironment, tDNA, migration_threads());
+        tIslands->setMigration(tMigration);
+        tPopulation = tIslands;
+        std::cout << "* Running as island " << migration_island() << std::endl;
+    } else
+        tPopulation = new PopSingleStraight(&tEnvironment, tDNA);
     std::cout << "* Evolving" << std::endl;
 
     // Simulate
@@ -36,6 +36,7 @@
 #include "../../dna.h"
 #include "../../population.h"
 #include "../../populations/singlestraight.h"
+#include "../../populations/island.h"
 #include "../../environment.h"
 
 // Headers -- Parser
@@ -54,7 +55,6 @@
 // Headers -- System
 #include <initializer_list>
 #include <vector>
-#include <map>
 
 
 //
@@ -69,6 +69,10 @@ const unsigned int GAME_DROPDELAY = 1000;
 const unsigned int GAME_USERDELAY = 1000;
 const unsigned int GAME_SPEED = 5;
 
+// Headless games: the piece drops every GAME_DROPTICKS evaluations
+const unsigned int GAME_DROPTICKS = GAME_DROPDELAY / GAME_USERDELAY;
+const int GAME_SCREENHEIGHT = 480;
+
 
 
 //////////////////////
@@ -78,7 +82,8 @@ const unsigned int GAME_SPEED = 5;
 class EnvTetris : public Environment, public SimpleGrammar {
 public:
     // Constructor
-    EnvTetris();
+    //   headless environments don't initialise SDL, and simulate time
+    EnvTetris(bool iHeadless = false);
     ~EnvTetris();
 
     // Environment functionality
@@ -87,42 +92,41 @@ public:
     void update(const DNA*);
     bool condition();
     void explain(const DNA*);
+    Environment* clone() const;
 
     // Grammar functionality
     void setup();
     void block();
-    Value executeFunction(unsigned char, const std::vector<Value>&);
 
 protected:
     // Board control
-    Value rotate(std::vector<Value>);
-    Value left(std::vector<Value>);
-    Value right(std::vector<Value>);
-    Value down(std::vector<Value>);
-    Value drop(std::vector<Value>);
+    Value rotate(const Parameters&);
+    Value left(const Parameters&);
+    Value right(const Parameters&);
+    Value down(const Parameters&);
+    Value drop(const Parameters&);
 
     // Informational
-    Value block_current(std::vector<Value>);
-    Value block_next(std::vector<Value>);
-    Value pos_x(std::vector<Value>);
-    Value pos_y(std::vector<Value>);
-    Value rotation(std::vector<Value>);
-    Value size_x(std::vector<Value>);
-    Value size_y(std::vector<Value>);
+    Value block_current(const Parameters&);
+    Value block_next(const Parameters&);
+    Value pos_x(const Parameters&);
+    Value pos_y(const Parameters&);
+    Value rotation(const Parameters&);
+    Value size_x(const Parameters&);
+    Value size_y(const Parameters&);
 
     // Tests
-    Value is_block(std::vector<Value>);
-    Value is_free(std::vector<Value>);
+    Value is_block(const Parameters&);
+    Value is_free(const Parameters&);
 
 private:    
     // Grammar functionality
     Parser* mParser;
-    std::map<unsigned char, Value (EnvTetris::*)(std::vector<Value>)> mPointers;
-    unsigned char setPointer(Value (EnvTetris::*)(std::vector<Value>), std::string, std::initializer_list<Type>, Type);
+    unsigned char setPointer(Value (EnvTetris::*)(const Parameters&), std::string, std::initializer_list<Type>, Type);
 
 
     // Tetris functionality
-    Output mTetrisOutput;
+    Output* mTetrisOutput;
     Pieces mTetrisPieces;
     Board* mTetrisBoard;
     Game* mTetrisGame;
@@ -0,0 +1,394 @@
+/*
+ * evaluator.cpp
+ * Evolve - Fitness evaluation executors
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "evaluator.h"
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Evaluator
+//
+
+// Constructor with given environment
+Evaluator::Evaluator(Environment* inputEnvironment) {
+    dataEnvironment = inputEnvironment;
+    dataPending = 0;
+}
+
+// Destructor
+Evaluator::~Evaluator() {
+}
+
+// Submit a string, evaluating it right away
+void Evaluator::submit(const DNA* inputDNA, unsigned int inputTag) {
+    Result tempResult;
+    tempResult.tag = inputTag;
+    tempResult.fitness = -1;
+    try {
+        tempResult.fitness = dataEnvironment->fitness(inputDNA);
+    } catch (...) {
+        tempResult.exception = std::current_exception();
+    }
+    dataCompleted.push_back(tempResult);
+    dataPending++;
+}
+
+// Collect a result (false if no strings are pending)
+bool Evaluator::collect(unsigned int& outputTag, double& outputFitness) {
+    if (dataCompleted.empty())
+        return false;
+
+    Result tempResult = dataCompleted.front();
+    dataCompleted.pop_front();
+    dataPending--;
+    outputTag = tempResult.tag;
+    outputFitness = tempResult.fitness;
+
+    // Propagate the error of this string to the caller
+    if (tempResult.exception != std::exception_ptr())
+        std::rethrow_exception(tempResult.exception);
+    return true;
+}
+
+// Amount of submitted strings which haven't been collected
+unsigned int Evaluator::pending() const {
+    return dataPending;
+}
+
+
+//
+// Serial evaluator
+//
+
+// Constructor with given environment
+EvalSerial::EvalSerial(Environment* inputEnvironment) : Evaluator(inputEnvironment) {
+}
+
+// Evaluate all DNA strings in a single batch
+void EvalSerial::evaluate(const std::vector<const DNA*>& inputDNA, std::vector<double>& outputFitness) {
+    outputFitness.resize(inputDNA.size());
+    if (inputDNA.size() > 0)
+        dataEnvironment->fitness(&inputDNA[0], &outputFitness[0], inputDNA.size());
+}
+
+
+//
+// Threaded evaluator
+//
+
+// Constructor with given environment and amount of threads
+EvalThreaded::EvalThreaded(Environment* inputEnvironment, unsigned int inputThreads) : Evaluator(inputEnvironment) {
+    dataInput = 0;
+    dataOutput = 0;
+    dataGeneration = 0;
+    dataBusy = 0;
+    dataStop = false;
+
+    // Clone the environment for every additional thread
+    if (inputThreads < 1)
+        inputThreads = 1;
+    for (unsigned int i = 1; i < inputThreads; i++) {
+        Environment* tempClone = inputEnvironment->clone();
+        if (tempClone == 0) {
+            std::cout << "NOTE: environment cannot be cloned, evaluating serially" << std::endl;
+            break;
+        }
+        dataClones.push_back(tempClone);
+    }
+    dataThreads = dataClones.size() + 1;
+}
+
+// Destructor
+EvalThreaded::~EvalThreaded() {
+    stop();
+    for (unsigned int i = 0; i < dataClones.size(); i++)
+        delete dataClones[i];
+}
+
+// Evaluate all DNA strings concurrently
+void EvalThreaded::evaluate(const std::vector<const DNA*>& inputDNA, std::vector<double>& outputFitness) {
+    outputFitness.resize(inputDNA.size());
+    if (inputDNA.size() == 0)
+        return;
+
+    // Publish the job
+    {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        dataInput = &inputDNA;
+        dataOutput = &outputFitness;
+        dataException = std::exception_ptr();
+        schedule(inputDNA.size());
+        dataBusy = dataWorkers.size();
+        dataGeneration++;
+    }
+    dataStart.notify_all();
+
+    // Participate using the original environment
+    process(0, dataEnvironment);
+
+    // Wait for the workers to finish
+    std::unique_lock<std::mutex> tempLock(dataMutex);
+    while (dataBusy > 0)
+        dataDone.wait(tempLock);
+    dataInput = 0;
+    dataOutput = 0;
+
+    // Propagate errors to the caller
+    if (dataException != std::exception_ptr())
+        std::rethrow_exception(dataException);
+}
+
+// Queue a string for evaluation
+void EvalThreaded::submit(const DNA* inputDNA, unsigned int inputTag) {
+    {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        dataJobs.push_back(std::make_pair(inputDNA, inputTag));
+    }
+    dataPending++;
+    dataStart.notify_one();
+}
+
+// Collect a result, evaluating queued strings while none is available
+// (false if no strings are pending)
+bool EvalThreaded::collect(unsigned int& outputTag, double& outputFitness) {
+    if (dataPending == 0)
+        return false;
+
+    std::unique_lock<std::mutex> tempLock(dataMutex);
+    while (dataResults.empty()) {
+        if (dataJobs.empty()) {
+            dataCollected.wait(tempLock);
+            continue;
+        }
+        std::pair<const DNA*, unsigned int> tempJob = dataJobs.front();
+        dataJobs.pop_front();
+        tempLock.unlock();
+        execute(dataEnvironment, tempJob);
+        tempLock.lock();
+    }
+    Result tempResult = dataResults.front();
+    dataResults.pop_front();
+    dataPending--;
+    outputTag = tempResult.tag;
+    outputFitness = tempResult.fitness;
+
+    // Propagate the error of this string to the caller
+    if (tempResult.exception != std::exception_ptr())
+        std::rethrow_exception(tempResult.exception);
+    return true;
+}
+
+// Amount of threads
+unsigned int EvalThreaded::threads() const {
+    return dataThreads;
+}
+
+// Start the worker threads
+//   needs to be called by derived classes, once they are fully constructed
+void EvalThreaded::start() {
+    for (unsigned int i = 0; i < dataClones.size(); i++)
+        dataWorkers.push_back(std::thread(&EvalThreaded::work, this, i+1));
+}
+
+// Stop the worker threads
+void EvalThreaded::stop() {
+    {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        dataStop = true;
+    }
+    dataStart.notify_all();
+    for (unsigned int i = 0; i < dataWorkers.size(); i++)
+        dataWorkers[i].join();
+    dataWorkers.clear();
+}
+
+// Worker loop
+void EvalThreaded::work(unsigned int inputWorker) {
+    unsigned long tempGeneration = 0;
+    while (true) {
+        // Wait for a new job, or for an asynchronous one
+        {
+            std::unique_lock<std::mutex> tempLock(dataMutex);
+            while (!dataStop && dataGeneration == tempGeneration && dataJobs.empty())
+                dataStart.wait(tempLock);
+            if (dataStop)
+                return;
+            if (dataGeneration == tempGeneration) {
+                std::pair<const DNA*, unsigned int> tempJob = dataJobs.front();
+                dataJobs.pop_front();
+                tempLock.unlock();
+                execute(dataClones[inputWorker-1], tempJob);
+                continue;
+            }
+            tempGeneration = dataGeneration;
+        }
+
+        // Process the job
+        process(inputWorker, dataClones[inputWorker-1]);
+
+        // Signal completion
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        if (--dataBusy == 0)
+            dataDone.notify_one();
+    }
+}
+
+// Size of a chunk of work
+unsigned int EvalThreaded::chunk(unsigned int inputSize) const {
+    unsigned int tempChunk = inputSize / (dataThreads * EVALUATOR_CHUNKS);
+    return tempChunk > 0 ? tempChunk : 1;
+}
+
+// Evaluate scheduled chunks until none are left
+void EvalThreaded::process(unsigned int inputWorker, Environment* inputEnvironment) {
+    unsigned int tempStart, tempEnd;
+    while (next(inputWorker, tempStart, tempEnd)) {
+        try {
+            inputEnvironment->fitness(&(*dataInput)[tempStart], &(*dataOutput)[tempStart], tempEnd-tempStart);
+        } catch (...) {
+            std::lock_guard<std::mutex> tempLock(dataMutex);
+            if (dataException == std::exception_ptr())
+                dataException = std::current_exception();
+        }
+    }
+}
+
+
+// Evaluate an asynchronous job, and queue its result
+void EvalThreaded::execute(Environment* inputEnvironment, const std::pair<const DNA*, unsigned int>& inputJob) {
+    Result tempResult;
+    tempResult.tag = inputJob.second;
+    tempResult.fitness = -1;
+    try {
+        tempResult.fitness = inputEnvironment->fitness(inputJob.first);
+    } catch (...) {
+        tempResult.exception = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        dataResults.push_back(tempResult);
+    }
+    dataCollected.notify_one();
+}
+
+
+//
+// Pool evaluator
+//
+
+// Constructor with given environment and amount of threads
+EvalPool::EvalPool(Environment* inputEnvironment, unsigned int inputThreads) : EvalThreaded(inputEnvironment, inputThreads) {
+    dataNext = 0;
+    dataSize = 0;
+    dataChunk = 1;
+    start();
+}
+
+// Destructor
+EvalPool::~EvalPool() {
+    stop();
+}
+
+// Reset the shared counter
+void EvalPool::schedule(unsigned int inputSize) {
+    dataSize = inputSize;
+    dataChunk = chunk(inputSize);
+    dataNext = 0;
+}
+
+// Fetch the next chunk from the shared counter
+bool EvalPool::next(unsigned int inputWorker, unsigned int& outputStart, unsigned int& outputEnd) {
+    outputStart = dataNext.fetch_add(dataChunk);
+    if (outputStart >= dataSize)
+        return false;
+    outputEnd = std::min(outputStart + dataChunk, dataSize);
+    return true;
+}
+
+
+//
+// Work-stealing evaluator
+//
+
+// Constructor with given environment and amount of threads
+EvalStealing::EvalStealing(Environment* inputEnvironment, unsigned int inputThreads) : EvalThreaded(inputEnvironment, inputThreads) {
+    for (unsigned int i = 0; i < dataThreads; i++)
+        dataQueues.push_back(new Queue());
+    start();
+}
+
+// Destructor
+EvalStealing::~EvalStealing() {
+    stop();
+    for (unsigned int i = 0; i < dataQueues.size(); i++)
+        delete dataQueues[i];
+}
+
+// Divide the items in chunks, and hand out contiguous runs of chunks to all queues
+void EvalStealing::schedule(unsigned int inputSize) {
+    unsigned int tempChunk = chunk(inputSize);
+    unsigned int tempChunks = (inputSize + tempChunk - 1) / tempChunk;
+    for (unsigned int i = 0; i < dataThreads; i++) {
+        std::lock_guard<std::mutex> tempLock(dataQueues[i]->mutex);
+        dataQueues[i]->items.clear();
+        for (unsigned int j = i * tempChunks / dataThreads; j < (i+1) * tempChunks / dataThreads; j++)
+            dataQueues[i]->items.push_back(std::make_pair(j * tempChunk, std::min((j+1) * tempChunk, inputSize)));
+    }
+}
+
+// Fetch a chunk from the own queue, or steal one
+bool EvalStealing::next(unsigned int inputWorker, unsigned int& outputStart, unsigned int& outputEnd) {
+    for (unsigned int i = 0; i < dataThreads; i++) {
+        Queue* tempQueue = dataQueues[(inputWorker+i) % dataThreads];
+        std::lock_guard<std::mutex> tempLock(tempQueue->mutex);
+        if (tempQueue->items.empty())
+            continue;
+
+        // Own work is taken from the front, stolen work from the back
+        std::pair<unsigned int, unsigned int> tempItem;
+        if (i == 0) {
+            tempItem = tempQueue->items.front();
+            tempQueue->items.pop_front();
+        } else {
+            tempItem = tempQueue->items.back();
+            tempQueue->items.pop_back();
+        }
+        outputStart = tempItem.first;
+        outputEnd = tempItem.second;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,219 @@
+/*
+ * evaluator.h
+ * Evolve - Fitness evaluation executors
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __EVALUATOR
+#define __EVALUATOR
+
+// Headers
+#include "environment.h"
+#include "dna.h"
+#include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+
+
+//
+// Constants
+//
+
+// Amount of chunks each thread receives per evaluation
+const unsigned int EVALUATOR_CHUNKS = 4;
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Evaluator interface
+//   besides evaluating batches, strings can be submitted one by one, with
+//   a tag to recognise their result by; results get collected in the order
+//   they complete, and an error raised while evaluating a string gets thrown
+//   when its result gets collected. Submitted strings have to stay alive and
+//   unmodified until their result got collected, and both ways of evaluating
+//   shouldn't be mixed while submissions are outstanding. The default
+//   implementation evaluates strings when they get submitted.
+class Evaluator
+{
+    public:
+        // Construction and destruction
+        Evaluator(Environment* inputEnvironment);
+        virtual ~Evaluator();
+
+        // Evaluate a set of DNA strings
+        virtual void evaluate(const std::vector<const DNA*>& inputDNA, std::vector<double>& outputFitness) = 0;
+
+        // Evaluate DNA strings asynchronously
+        virtual void submit(const DNA* inputDNA, unsigned int inputTag);
+        virtual bool collect(unsigned int& outputTag, double& outputFitness);
+        unsigned int pending() const;
+
+    protected:
+        Environment* dataEnvironment;
+
+        // Result of a submitted string, carrying the error its evaluation
+        // raised (if any)
+        struct Result {
+            unsigned int tag;
+            double fitness;
+            std::exception_ptr exception;
+        };
+
+        // Amount of submitted strings which haven't been collected
+        unsigned int dataPending;
+
+    private:
+        std::deque<Result> dataCompleted;
+};
+
+// Serial evaluation, within the calling thread
+class EvalSerial : public Evaluator
+{
+    public:
+        // Construction and destruction
+        EvalSerial(Environment* inputEnvironment);
+
+        // Required functions
+        void evaluate(const std::vector<const DNA*>& inputDNA, std::vector<double>& outputFitness);
+};
+
+// Threaded evaluation (base class)
+//   the calling thread evaluates using the original environment, while
+//   every additional worker thread owns a clone of it; if the environment
+//   cannot be cloned, all evaluations happen serially
+class EvalThreaded : public Evaluator
+{
+    public:
+        // Construction and destruction
+        EvalThreaded(Environment* inputEnvironment, unsigned int inputThreads);
+        ~EvalThreaded();
+
+        // Required functions
+        void evaluate(const std::vector<const DNA*>& inputDNA, std::vector<double>& outputFitness);
+
+        // Asynchronous evaluation (evaluated by the workers, and by the
+        // calling thread while it waits for results)
+        void submit(const DNA* inputDNA, unsigned int inputTag);
+        bool collect(unsigned int& outputTag, double& outputFitness);
+
+        // Informational routines
+        unsigned int threads() const;
+
+    protected:
+        // Scheduling
+        virtual void schedule(unsigned int inputSize) = 0;
+        virtual bool next(unsigned int inputWorker, unsigned int& outputStart, unsigned int& outputEnd) = 0;
+        unsigned int chunk(unsigned int inputSize) const;
+
+        // Worker management
+        void start();
+        void stop();
+
+        // Worker count (including the calling thread)
+        unsigned int dataThreads;
+
+    private:
+        // Worker routines
+        void work(unsigned int inputWorker);
+        void process(unsigned int inputWorker, Environment* inputEnvironment);
+        void execute(Environment* inputEnvironment, const std::pair<const DNA*, unsigned int>& inputJob);
+
+        // Worker data
+        std::vector<std::thread> dataWorkers;
+        std::vector<Environment*> dataClones;
+
+        // Job data
+        const std::vector<const DNA*>* dataInput;
+        std::vector<double>* dataOutput;
+        unsigned long dataGeneration;
+        unsigned int dataBusy;
+        bool dataStop;
+        std::exception_ptr dataException;
+
+        // Asynchronous jobs and their results
+        std::deque<std::pair<const DNA*, unsigned int> > dataJobs;
+        std::deque<Result> dataResults;
+
+        // Synchronisation
+        std::mutex dataMutex;
+        std::condition_variable dataStart, dataDone, dataCollected;
+};
+
+// Thread pool, pulling chunks of work from a shared counter
+class EvalPool : public EvalThreaded
+{
+    public:
+        // Construction and destruction
+        EvalPool(Environment* inputEnvironment, unsigned int inputThreads = std::thread::hardware_concurrency());
+        ~EvalPool();
+
+    protected:
+        // Scheduling
+        void schedule(unsigned int inputSize);
+        bool next(unsigned int inputWorker, unsigned int& outputStart, unsigned int& outputEnd);
+
+    private:
+        std::atomic<unsigned int> dataNext;
+        unsigned int dataSize, dataChunk;
+};
+
+// Work-stealing pool, where every worker owns a queue of chunks and idle
+// workers steal from the back of other queues
+class EvalStealing : public EvalThreaded
+{
+    public:
+        // Construction and destruction
+        EvalStealing(Environment* inputEnvironment, unsigned int inputThreads = std::thread::hardware_concurrency());
+        ~EvalStealing();
+
+    protected:
+        // Scheduling
+        void schedule(unsigned int inputSize);
+        bool next(unsigned int inputWorker, unsigned int& outputStart, unsigned int& outputEnd);
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::pair<unsigned int, unsigned int> > items;
+        };
+        std::vector<Queue*> dataQueues;
+};
+
+
+// Include guard
+#endif
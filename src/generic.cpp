@@ -28,30 +28,189 @@
 // Essential stuff
 //
 
+// Headers
+#include "generic.h"
+#include <mutex>
+#include <memory>
+#include <chrono>
+
 // Global variables
-bool GENERIC_SRAND = false;
+static std::mutex GENERIC_MUTEX;
+static bool GENERIC_SEEDED = false;
+static uint64_t GENERIC_SEED = 0;
+static unsigned int GENERIC_STREAMS = 0;
+static thread_local std::unique_ptr<Generator> GENERIC_GENERATOR;
 
 
-// Headers
-#include "generic.h"
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Auxiliary
+//
+
+// SplitMix64, used to expand seeds
+static uint64_t splitmix(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+
+//
+// xoshiro256**
+//
+
+// Constructor with given seed
+GenXoshiro::GenXoshiro(uint64_t inputSeed)
+{
+	seed(inputSeed);
+}
+
+// Seed the state
+void GenXoshiro::seed(uint64_t inputSeed)
+{
+	for (int i = 0; i < 4; i++)
+		dataState[i] = splitmix(inputSeed);
+}
+
+// Generate 64 random bits
+uint64_t GenXoshiro::next()
+{
+	uint64_t result = rotl(dataState[1] * 5, 7) * 9;
+	uint64_t t = dataState[1] << 17;
+
+	dataState[2] ^= dataState[0];
+	dataState[3] ^= dataState[1];
+	dataState[1] ^= dataState[2];
+	dataState[0] ^= dataState[3];
+	dataState[2] ^= t;
+	dataState[3] = rotl(dataState[3], 45);
+
+	return result;
+}
+
+
+//
+// PCG-XSH-RR
+//
+
+// Constructor with given seed
+GenPCG::GenPCG(uint64_t inputSeed)
+{
+	seed(inputSeed);
+}
+
+// Seed the state and pick a stream
+void GenPCG::seed(uint64_t inputSeed)
+{
+	dataIncrement = (splitmix(inputSeed) << 1) | 1;
+	dataState = 0;
+	step();
+	dataState += splitmix(inputSeed);
+	step();
+}
+
+// Generate 32 random bits
+uint32_t GenPCG::step()
+{
+	uint64_t old = dataState;
+	dataState = old * 6364136223846793005ULL + dataIncrement;
+	uint32_t xorshifted = (uint32_t) (((old >> 18) ^ old) >> 27);
+	uint32_t rot = (uint32_t) (old >> 59);
+	return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+// Generate 64 random bits
+uint64_t GenPCG::next()
+{
+	uint64_t high = step();
+	return (high << 32) | step();
+}
+
 
 
 //////////////
 // ROUTINES //
 //////////////
 
-// Generate a number from lower up to (exclusive) upper
-int random_int(int lowest_number, int highest_number)
+// Seed of a given stream
+//   needs to be called with the mutex held
+static uint64_t random_stream(unsigned int stream)
+{
+	if (!GENERIC_SEEDED) {
+		GENERIC_SEED = (uint64_t) time(0);
+		GENERIC_SEEDED = true;
+		std::cout << "DEBUG: using seed " << GENERIC_SEED << std::endl;
+	}
+	return GENERIC_SEED ^ (stream * 0xD1B54A32D192ED03ULL);
+}
+
+// Seed the generators
+void random_seed(uint64_t inputSeed)
+{
+	std::lock_guard<std::mutex> tempLock(GENERIC_MUTEX);
+	GENERIC_SEED = inputSeed;
+	GENERIC_SEEDED = true;
+	GENERIC_STREAMS = 1;
+
+	if (GENERIC_GENERATOR.get() == 0)
+		GENERIC_GENERATOR.reset(new GenXoshiro());
+	GENERIC_GENERATOR->seed(random_stream(0));
+}
+
+// Get the seed
+uint64_t random_seed()
+{
+	std::lock_guard<std::mutex> tempLock(GENERIC_MUTEX);
+	random_stream(0);
+	return GENERIC_SEED;
+}
+
+// Get the generator of the calling thread
+Generator& random_generator()
+{
+	if (GENERIC_GENERATOR.get() == 0) {
+		std::lock_guard<std::mutex> tempLock(GENERIC_MUTEX);
+		GENERIC_GENERATOR.reset(new GenXoshiro(random_stream(GENERIC_STREAMS++)));
+	}
+	return *GENERIC_GENERATOR;
+}
+
+// Replace the generator of the calling thread
+void random_generator(Generator* inputGenerator)
 {
-	// Set seed
-	if (!GENERIC_SRAND) {
-                unsigned int seed = (unsigned)time(0);
+	GENERIC_GENERATOR.reset(inputGenerator);
+}
 
-                std::cout << "DEBUG: using seed " << (unsigned)time(0) << std::endl;                
-		srand(seed);
-		GENERIC_SRAND = true;
+// Generate an unbiased number from 0 up to (exclusive) range
+//   Lemire, "Fast Random Integer Generation in an Interval" (2019)
+static inline uint32_t random_bounded(Generator& generator, uint32_t range)
+{
+	uint64_t m = (generator.next() >> 32) * range;
+	uint32_t l = (uint32_t) m;
+	if (l < range) {
+		uint32_t t = (-range) % range;
+		while (l < t) {
+			m = (generator.next() >> 32) * range;
+			l = (uint32_t) m;
+		}
 	}
+	return (uint32_t) (m >> 32);
+}
 
+// Generate a number from lower up to (exclusive) upper
+int random_int(int lowest_number, int highest_number)
+{
 	// Swap the numbers if needed
 	if (lowest_number > highest_number)
 	{
@@ -59,17 +218,38 @@ int random_int(int lowest_number, int highest_number)
 	}
 
 	// Calculate the range
-	int range = highest_number - lowest_number;
-
-	// Return a number (using lower-order bits)
-	//return lowest_number + rand()%range;
+	uint32_t range = (uint32_t) highest_number - (uint32_t) lowest_number;
+	if (range == 0)
+		return lowest_number;
 
-	// Return a number (using high-order bits)
-	// Numerical Recipes in C: The Art of Scientific Computing
-	//   (William H. Press, Brian P. Flannery, Saul A. Teukolsky,
-	//   William T. Vetterling; New York: Cambridge University Press,
-	//   1992 (2nd ed., p. 277))
-	return int(lowest_number + range*(rand()/(RAND_MAX+1.0)));
+	return (int) ((uint32_t) lowest_number + random_bounded(random_generator(), range));
 }
 
+// Fill a buffer with numbers from lower up to (exclusive) upper
+void random_fill(unsigned char* output, unsigned int size, int lowest_number, int highest_number)
+{
+	// Swap the numbers if needed
+	if (lowest_number > highest_number)
+	{
+		std::swap(lowest_number, highest_number);
+	}
+
+	// Calculate the range
+	uint32_t range = (uint32_t) highest_number - (uint32_t) lowest_number;
+	if (range == 0) {
+		for (unsigned int i = 0; i < size; i++)
+			output[i] = (unsigned char) lowest_number;
+		return;
+	}
+
+	// Generate the numbers, using a single generator lookup
+	Generator& generator = random_generator();
+	for (unsigned int i = 0; i < size; i++)
+		output[i] = (unsigned char) (lowest_number + random_bounded(generator, range));
+}
 
+// Elapsed wall-clock time in seconds
+double wall_time()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
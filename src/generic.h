@@ -40,6 +40,66 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <stdint.h>
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Random number generator interface
+//   models a uniform random bit generator, so it can be passed to the
+//   standard algorithms (e.g. std::shuffle)
+class Generator
+{
+	public:
+		// Construction and destruction
+		virtual ~Generator() {}
+
+		// Seeding
+		virtual void seed(uint64_t inputSeed) = 0;
+
+		// Generate 64 random bits
+		virtual uint64_t next() = 0;
+
+		// Standard interface
+		typedef uint64_t result_type;
+		static constexpr uint64_t min() { return 0; }
+		static constexpr uint64_t max() { return UINT64_MAX; }
+		uint64_t operator() () { return next(); }
+};
+
+// xoshiro256** generator (Blackman & Vigna)
+class GenXoshiro : public Generator
+{
+	public:
+		// Construction and destruction
+		GenXoshiro(uint64_t inputSeed = 0);
+
+		// Required functions
+		void seed(uint64_t inputSeed);
+		uint64_t next();
+
+	private:
+		uint64_t dataState[4];
+};
+
+// PCG-XSH-RR generator (O'Neill), combining two 32-bit outputs
+class GenPCG : public Generator
+{
+	public:
+		// Construction and destruction
+		GenPCG(uint64_t inputSeed = 0);
+
+		// Required functions
+		void seed(uint64_t inputSeed);
+		uint64_t next();
+
+	private:
+		uint32_t step();
+		uint64_t dataState, dataIncrement;
+};
 
 
 //////////////
@@ -57,9 +117,25 @@ swap(X &a, X &b)
 }
 */
 
+// Seed the generators (the calling thread gets reseeded, other threads
+// derive their own stream from the seed when they first draw a number)
+void random_seed(uint64_t inputSeed);
+uint64_t random_seed();
+
+// Get the generator of the calling thread, or replace it (takes ownership)
+Generator& random_generator();
+void random_generator(Generator* inputGenerator);
+
 // Generate a number from lower up to (exclusive) upper
 int random_int(int lowest_number, int highest_number);
 
+// Fill a buffer with numbers from lower up to (exclusive) upper
+void random_fill(unsigned char* output, unsigned int size, int lowest_number, int highest_number);
+
+// Elapsed wall-clock time in seconds (unlike clock(), which measures
+// processor time and runs faster when working on multiple threads)
+double wall_time();
+
 // Convert several types to a string
 template <typename X>
 std::string stringify(X input)
@@ -0,0 +1,327 @@
+/*
+ * migration.cpp
+ * Evolve - Migration of DNA between processes
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "migration.h"
+#include "generic.h"
+#include <thread>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Migration
+//
+
+// Destructor
+Migration::~Migration() {
+}
+
+
+//
+// Socket migration
+//
+
+// Constructor, with the index of the island (which tags its messages)
+MigSocket::MigSocket(int inputIsland) {
+    dataSocket = -1;
+    dataIsland = inputIsland;
+}
+
+// Destructor
+MigSocket::~MigSocket() {
+    if (dataSocket != -1)
+        close(dataSocket);
+}
+
+// Connect to a coordinator
+bool MigSocket::connect(const std::string& inputPath) {
+    sockaddr_un tempAddress = sockaddr_un();
+    if (inputPath.size() >= sizeof(tempAddress.sun_path))
+        return false;
+    tempAddress.sun_family = AF_UNIX;
+    inputPath.copy(tempAddress.sun_path, inputPath.size());
+
+    dataSocket = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (dataSocket == -1)
+        return false;
+    if (::connect(dataSocket, (sockaddr*) &tempAddress, sizeof(tempAddress)) == -1) {
+        close(dataSocket);
+        dataSocket = -1;
+        return false;
+    }
+    return true;
+}
+
+// Send a migrant (which gets dropped if the socket is congested)
+bool MigSocket::send(const DNA& inputDNA, double inputFitness) {
+    if (dataSocket == -1)
+        return false;
+
+    dataBuffer.clear();
+    migration_pack(dataIsland, inputDNA, inputFitness, dataBuffer);
+    return ::send(dataSocket, &dataBuffer[0], dataBuffer.size(), MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t) dataBuffer.size();
+}
+
+// Receive a migrant, skipping invalid messages
+bool MigSocket::receive(DNA& outputDNA, double& outputFitness) {
+    while (dataSocket != -1) {
+        // Get the size of the next message
+        unsigned char tempByte;
+        ssize_t tempSize = recv(dataSocket, &tempByte, 1, MSG_DONTWAIT | MSG_PEEK | MSG_TRUNC);
+        if (tempSize == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            return false;
+        if (tempSize <= 0) {
+            // The coordinator went away
+            close(dataSocket);
+            dataSocket = -1;
+            return false;
+        }
+
+        dataBuffer.resize(tempSize);
+        if (recv(dataSocket, &dataBuffer[0], tempSize, MSG_DONTWAIT) != tempSize)
+            continue;
+        int tempIsland;
+        if (migration_unpack(&dataBuffer[0], tempSize, tempIsland, outputDNA, outputFitness))
+            return true;
+    }
+    return false;
+}
+
+
+//
+// Coordinator
+//
+
+// Constructor
+MigCoordinator::MigCoordinator(TOPOLOGY inputTopology) {
+    dataTopology = inputTopology;
+    dataSocket = -1;
+    dataFitness = 0;
+}
+
+// Destructor
+MigCoordinator::~MigCoordinator() {
+    for (unsigned int i = 0; i < dataIslands.size(); i++)
+        close(dataIslands[i]);
+    if (dataSocket != -1) {
+        close(dataSocket);
+        unlink(dataPath.c_str());
+    }
+}
+
+// Listen for islands on a socket
+bool MigCoordinator::listen(const std::string& inputPath) {
+    sockaddr_un tempAddress = sockaddr_un();
+    if (inputPath.size() >= sizeof(tempAddress.sun_path))
+        return false;
+    tempAddress.sun_family = AF_UNIX;
+    inputPath.copy(tempAddress.sun_path, inputPath.size());
+
+    dataSocket = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (dataSocket == -1)
+        return false;
+    unlink(inputPath.c_str());
+    if (bind(dataSocket, (sockaddr*) &tempAddress, sizeof(tempAddress)) == -1 || ::listen(dataSocket, SOMAXCONN) == -1) {
+        close(dataSocket);
+        dataSocket = -1;
+        return false;
+    }
+    dataPath = inputPath;
+    return true;
+}
+
+// Accept islands and relay messages
+void MigCoordinator::relay(int inputTimeout) {
+    if (dataSocket == -1)
+        return;
+
+    // Wait for activity
+    std::vector<pollfd> tempPoll(dataIslands.size() + 1);
+    tempPoll[0].fd = dataSocket;
+    tempPoll[0].events = POLLIN;
+    for (unsigned int i = 0; i < dataIslands.size(); i++) {
+        tempPoll[i+1].fd = dataIslands[i];
+        tempPoll[i+1].events = POLLIN;
+    }
+    if (poll(&tempPoll[0], tempPoll.size(), inputTimeout) <= 0)
+        return;
+
+    // Relay messages (backwards, as islands might disconnect)
+    for (unsigned int i = dataIslands.size(); i-- > 0;) {
+        if (tempPoll[i+1].revents == 0)
+            continue;
+
+        unsigned char tempByte;
+        ssize_t tempSize = recv(dataIslands[i], &tempByte, 1, MSG_DONTWAIT | MSG_PEEK | MSG_TRUNC);
+        if (tempSize == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            continue;
+        if (tempSize <= 0) {
+            disconnect(i);
+            continue;
+        }
+
+        dataBuffer.resize(tempSize);
+        if (recv(dataIslands[i], &dataBuffer[0], tempSize, MSG_DONTWAIT) != tempSize)
+            continue;
+        int tempIsland;
+        DNA tempDNA({});
+        double tempFitness;
+        if (!migration_unpack(&dataBuffer[0], tempSize, tempIsland, tempDNA, tempFitness))
+            continue;
+        if (tempFitness > dataFitness) {
+            dataFitness = tempFitness;
+            std::cout << "NOTE: island " << tempIsland << " reached " << 100 * tempFitness << " points" << std::endl;
+        }
+        forward(i, dataBuffer);
+    }
+
+    // Accept new islands
+    if (tempPoll[0].revents & POLLIN) {
+        int tempIsland = accept(dataSocket, 0, 0);
+        if (tempIsland != -1)
+            dataIslands.push_back(tempIsland);
+    }
+}
+
+// Amount of connected islands
+unsigned int MigCoordinator::islands() const {
+    return dataIslands.size();
+}
+
+// Best fitness value relayed
+double MigCoordinator::fitness() const {
+    return dataFitness;
+}
+
+// Forward a message to the neighbours of an island (dropping it for those
+// which are congested)
+void MigCoordinator::forward(unsigned int inputIsland, const std::vector<unsigned char>& inputMessage) {
+    unsigned int tempIslands = dataIslands.size();
+    if (tempIslands < 2)
+        return;
+
+    std::vector<unsigned int> tempTargets;
+    switch (dataTopology) {
+        case TOPOLOGY_RING:
+            tempTargets.push_back((inputIsland + 1) % tempIslands);
+            break;
+        case TOPOLOGY_FULL:
+            for (unsigned int i = 0; i < tempIslands; i++)
+                if (i != inputIsland)
+                    tempTargets.push_back(i);
+            break;
+        case TOPOLOGY_RANDOM:
+            tempTargets.push_back((inputIsland + random_int(1, tempIslands)) % tempIslands);
+            break;
+    }
+
+    for (unsigned int i = 0; i < tempTargets.size(); i++)
+        ::send(dataIslands[tempTargets[i]], &inputMessage[0], inputMessage.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+// Drop an island
+void MigCoordinator::disconnect(unsigned int inputIsland) {
+    close(dataIslands[inputIsland]);
+    dataIslands.erase(dataIslands.begin() + inputIsland);
+}
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+// Encode a message
+void migration_pack(int inputIsland, const DNA& inputDNA, double inputFitness, std::vector<unsigned char>& outputMessage) {
+    outputMessage.insert(outputMessage.end(), MIGRATION_MAGIC, MIGRATION_MAGIC + 4);
+    uint32_t tempIsland = (uint32_t) inputIsland;
+    for (unsigned int i = 0; i < 4; i++)
+        outputMessage.push_back((tempIsland >> (8*i)) & 0xFF);
+    uint64_t tempFitness;
+    memcpy(&tempFitness, &inputFitness, 8);
+    for (unsigned int i = 0; i < 8; i++)
+        outputMessage.push_back((tempFitness >> (8*i)) & 0xFF);
+    inputDNA.serialize(outputMessage);
+}
+
+// Decode a message (which should be complete)
+bool migration_unpack(const unsigned char* inputMessage, unsigned int inputSize, int& outputIsland, DNA& outputDNA, double& outputFitness) {
+    if (inputSize < MIGRATION_OVERHEAD || memcmp(inputMessage, MIGRATION_MAGIC, 4) != 0)
+        return false;
+
+    uint32_t tempIsland = 0;
+    for (unsigned int i = 0; i < 4; i++)
+        tempIsland |= (uint32_t) inputMessage[4+i] << (8*i);
+    uint64_t tempFitness = 0;
+    for (unsigned int i = 0; i < 8; i++)
+        tempFitness |= (uint64_t) inputMessage[8+i] << (8*i);
+    if (outputDNA.deserialize(inputMessage + 16, inputSize - 16) != (int) (inputSize - 16))
+        return false;
+    outputIsland = (int) tempIsland;
+    memcpy(&outputFitness, &tempFitness, 8);
+    return true;
+}
+
+// Connect to the coordinator which launched this process
+Migration* migration_connect() {
+    const char* tempPath = getenv(MIGRATION_SOCKET);
+    if (tempPath == 0)
+        return 0;
+
+    MigSocket* tempMigration = new MigSocket(migration_island());
+    if (!tempMigration->connect(tempPath)) {
+        delete tempMigration;
+        return 0;
+    }
+    return tempMigration;
+}
+
+// Index of this island
+int migration_island() {
+    const char* tempIsland = getenv(MIGRATION_ISLAND);
+    return tempIsland == 0 ? -1 : atoi(tempIsland);
+}
+
+// Amount of threads this island should use
+unsigned int migration_threads() {
+    const char* tempThreads = getenv(MIGRATION_THREADS);
+    if (tempThreads != 0 && atoi(tempThreads) > 0)
+        return atoi(tempThreads);
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
@@ -0,0 +1,161 @@
+/*
+ * migration.h
+ * Evolve - Migration of DNA between processes
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __MIGRATION
+#define __MIGRATION
+
+// Headers
+#include "dna.h"
+#include <string>
+#include <vector>
+
+
+//
+// Constants
+//
+
+// Migration topologies
+enum TOPOLOGY {
+    TOPOLOGY_RING,          // every island sends its elite to the next one
+    TOPOLOGY_FULL,          // every island sends its elite to all others
+    TOPOLOGY_RANDOM         // every island sends its elite to a random other
+};
+
+// Messages: a magic number (which includes the format version), the index
+// of the sending island as a little-endian 32-bit integer, the fitness of
+// the migrant as a little-endian IEEE double, and its DNA
+const unsigned char MIGRATION_MAGIC[4] = {'E', 'V', 'M', 2};
+const unsigned int MIGRATION_OVERHEAD = 16 + DNA_SERIAL_OVERHEAD;
+
+// Environment variables through which the launcher configures islands: the
+// socket of the coordinator, the index of the island, and the amount of
+// threads it should use
+const char* const MIGRATION_SOCKET = "EVOLVE_MIGRATION";
+const char* const MIGRATION_ISLAND = "EVOLVE_ISLAND";
+const char* const MIGRATION_THREADS = "EVOLVE_THREADS";
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Migration interface
+//   exchanges migrants with other islands, without ever blocking: sending
+//   fails rather than waits, and receiving fails if nothing has arrived
+class Migration
+{
+    public:
+        // Construction and destruction
+        virtual ~Migration();
+
+        // Exchange migrants
+        virtual bool send(const DNA& inputDNA, double inputFitness) = 0;
+        virtual bool receive(DNA& outputDNA, double& outputFitness) = 0;
+};
+
+// Migration through the Unix domain socket of a coordinator
+//   uses a sequenced packet socket, so every message arrives whole
+class MigSocket : public Migration
+{
+    public:
+        // Construction and destruction
+        MigSocket(int inputIsland = -1);
+        ~MigSocket();
+
+        // Connection
+        bool connect(const std::string& inputPath);
+
+        // Required functions
+        bool send(const DNA& inputDNA, double inputFitness);
+        bool receive(DNA& outputDNA, double& outputFitness);
+
+    private:
+        int dataSocket, dataIsland;
+        std::vector<unsigned char> dataBuffer;
+};
+
+// Coordinator, relaying the messages of connected islands
+//   islands are ordered by the time they connected (which determines the
+//   ring), and invalid messages get dropped
+class MigCoordinator
+{
+    public:
+        // Construction and destruction
+        MigCoordinator(TOPOLOGY inputTopology = TOPOLOGY_RING);
+        ~MigCoordinator();
+
+        // Listen for islands on a socket
+        bool listen(const std::string& inputPath);
+
+        // Accept islands and relay messages, for at most a given amount of
+        // milliseconds
+        void relay(int inputTimeout);
+
+        // Informational routines
+        unsigned int islands() const;
+        double fitness() const;
+
+    private:
+        // Forward a message to the neighbours of an island
+        void forward(unsigned int inputIsland, const std::vector<unsigned char>& inputMessage);
+        void disconnect(unsigned int inputIsland);
+
+        TOPOLOGY dataTopology;
+        std::string dataPath;
+        int dataSocket;
+        std::vector<int> dataIslands;
+        std::vector<unsigned char> dataBuffer;
+        double dataFitness;
+};
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+// Encode and decode messages
+void migration_pack(int inputIsland, const DNA& inputDNA, double inputFitness, std::vector<unsigned char>& outputMessage);
+bool migration_unpack(const unsigned char* inputMessage, unsigned int inputSize, int& outputIsland, DNA& outputDNA, double& outputFitness);
+
+// Connect to the coordinator which launched this process (0 if none)
+Migration* migration_connect();
+
+// Index of this island, or -1 if not launched as one
+int migration_island();
+
+// Amount of threads this island should use
+unsigned int migration_threads();
+
+
+// Include guard
+#endif
@@ -117,6 +117,34 @@ private:
     std::string mDetails;
 };
 
+// Error code
+//   a lightweight alternative to exceptions, for code paths where errors are
+//   common and need to be cheap (e.g. validating random DNA); the message
+//   needs to be a string literal
+class Error {
+public:
+    Error() {
+        mType = GENERIC;
+        mMessage = "";
+    }
+    Error(EXCEPTIONTYPE iType, const char* iMessage) {
+        mType = iType;
+        mMessage = iMessage;
+    }
+    EXCEPTIONTYPE type() const {
+        return mType;
+    }
+    const char* what() const {
+        return mMessage;
+    }
+    Exception exception() const {
+        return Exception(mType, mMessage);
+    }
+private:
+    EXCEPTIONTYPE mType;
+    const char* mMessage;
+};
+
 
 // Include guard
 #endif
@@ -55,19 +55,25 @@ Function::Function(std::string iName, std::vector<Type> iParameters, const Type&
 // Data verification
 //
 
-// Check the parameters
-void Function::checkParameters(const std::vector<Value>& iParameters) const {
-    // Check input parameters
-    bool tParameterFailure = false;
+// Verify the parameters
+bool Function::validParameters(const Parameters& iParameters) const {
     if (mParameterTypes.size() != iParameters.size())
-        tParameterFailure = true;
-    else {
-        for (unsigned int i = 0; i < iParameters.size() && !tParameterFailure; i++) {
-            if (iParameters[i].getType() != mParameterTypes[i])
-                tParameterFailure = true;
-        }
+        return false;
+    for (unsigned int i = 0; i < iParameters.size(); i++) {
+        if (iParameters[i].getType() != mParameterTypes[i])
+            return false;
     }
-    if (tParameterFailure) {
+    return true;
+}
+
+// Verify the return value
+bool Function::validReturn(const Value& iReturn) const {
+    return iReturn.getType() == mReturnType;
+}
+
+// Check the parameters
+void Function::checkParameters(const Parameters& iParameters) const {
+    if (!validParameters(iParameters)) {
         std::stringstream details;
         details << "got called with [";
         for (unsigned int j = 0; j < iParameters.size(); j++) {
@@ -88,8 +94,7 @@ void Function::checkParameters(const std::vector<Value>& iParameters) const {
 
 // Check the return value
 void Function::checkReturn(const Value& iReturn) const {
-    // Check return value
-    if (iReturn.getType() != mReturnType) {
+    if (!validReturn(iReturn)) {
         std::stringstream details;
         details << "function returned " << iReturn.getType() << " while function definition was " << mReturnType;
         throw Exception(FUNCTION, "function returned invalid value", details.str());
@@ -56,7 +56,9 @@ public:
     Function(std::string, std::vector<Type>, const Type&);
 
     // Data verification
-    void checkParameters(const std::vector<Value>&) const;
+    bool validParameters(const Parameters&) const;
+    bool validReturn(const Value&) const;
+    void checkParameters(const Parameters&) const;
     void checkReturn(const Value&) const;
 
     // Data IO
@@ -44,6 +44,11 @@
 // Default constructor
 Grammar::Grammar() {
     mSetup = false;
+    mFailed = false;
+    for (unsigned int i = 0; i < 256; i++) {
+        mFunctions[i].function = 0;
+        mFunctions[i].handler = 0;
+    }
 }
 
 // Destructor
@@ -107,7 +112,15 @@ void Grammar::setFunction(unsigned char iByte, const Function* iFunction) {
     }
 
     // Save the function
-    mFunctions[iByte] = iFunction;
+    mFunctions[iByte].function = iFunction;
+    mFunctions[iByte].handler = 0;
+}
+
+// Set the handler of a function
+void Grammar::setHandler(unsigned char iByte, Handler iHandler) {
+    if (!isFunction(iByte))
+        throw Exception(FUNCTION, "attempt to set handler of undefined function");
+    mFunctions[iByte].handler = iHandler;
 }
 
 
@@ -118,12 +131,11 @@ const Function* Grammar::getFunction(unsigned char iByte) const {
         throw Exception(GENERIC, "grammar isn't configured yet");
 
     // The function must be defined
-    std::map<unsigned char, const Function*>::const_iterator it = mFunctions.find(iByte);
-    if (it == mFunctions.end()) {
+    if (mFunctions[iByte].function == 0) {
         throw Exception(FUNCTION, "unknown byte identifier");
     }
 
-    return it->second;
+    return mFunctions[iByte].function;
 }
 
 // Delete a function
@@ -134,7 +146,8 @@ void Grammar::deleteFunction(unsigned char iByte) {
 
     // Get the function pointer
     const Function* tFunction = getFunction(iByte);
-    mFunctions.erase(iByte);
+    mFunctions[iByte].function = 0;
+    mFunctions[iByte].handler = 0;
 
     // Check if we created the function
     std::list<const Function*>::iterator it2 = mCreatedFunctions.begin();
@@ -155,20 +168,61 @@ std::string Grammar::nameFunction(unsigned char iByte) const {
 }
 
 // Call a function
-Value Grammar::callFunction(unsigned char iByte, const std::vector<Value>& iParameters) {
+Value Grammar::callFunction(unsigned char iByte, const Parameters& iParameters) {
     // Get the function pointer
-    const Function* tFunction = getFunction(iByte);
+    return callFunction(getFunction(iByte), iByte, iParameters);
+}
 
-    // Check and execute the function
-    tFunction->checkParameters(iParameters);
-    Value tReturn = executeFunction(iByte, iParameters);
-    tFunction->checkReturn(tReturn);
+// Call a previously resolved function
+//   goes through the non-throwing call, and only when that fails re-runs
+//   the checks which describe the failure in detail
+Value Grammar::callFunction(const Function* iFunction, unsigned char iByte, const Parameters& iParameters) {
+    Value tReturn;
+    Error tError;
+    if (!callFunction(iFunction, iByte, iParameters, tReturn, tError)) {
+        iFunction->checkParameters(iParameters);
+        if (!mFailed)
+            iFunction->checkReturn(tReturn);
+        throw tError.exception();
+    }
     return tReturn;
 }
 
+// Call a previously resolved function, without throwing
+bool Grammar::callFunction(const Function* iFunction, unsigned char iByte, const Parameters& iParameters, Value& oReturn, Error& oError) {
+    // Check the parameters
+    if (!iFunction->validParameters(iParameters)) {
+        oError = Error(FUNCTION, "input parameters did not respect function signature");
+        return false;
+    }
+
+    // Execute the function
+    mFailed = false;
+    Handler tHandler = mFunctions[iByte].handler;
+    oReturn = (tHandler != 0) ? (this->*tHandler)(iParameters) : executeFunction(iByte, iParameters);
+    if (mFailed) {
+        oError = mError;
+        return false;
+    }
+
+    // Check the return value
+    if (!iFunction->validReturn(oReturn)) {
+        oError = Error(FUNCTION, "function returned invalid value");
+        return false;
+    }
+    return true;
+}
+
 // Execute a function
-Value Grammar::executeFunction(unsigned char, const std::vector<Value>&) {
-    throw Exception(FUNCTION, "execution request for properly defined function not aknowledged by any derivative grammar class");
+Value Grammar::executeFunction(unsigned char, const Parameters&) {
+    return fail(FUNCTION, "execution request for properly defined function not aknowledged by any derivative grammar class");
+}
+
+// Report an error from within a function
+Value Grammar::fail(EXCEPTIONTYPE iType, const char* iMessage) {
+    mFailed = true;
+    mError = Error(iType, iMessage);
+    return Value();
 }
 
 
@@ -199,6 +253,5 @@ bool Grammar::isData(unsigned char iByte) const {
 
 // Test if a byte identifier is linked with a function
 bool Grammar::isFunction(unsigned char iByte) const {
-    std::map<unsigned char, const Function*>::const_iterator it = mFunctions.find(iByte);
-    return it != mFunctions.end();
+    return mFunctions[iByte].function != 0;
 }
\ No newline at end of file
@@ -33,7 +33,6 @@
 #define __GRAMMAR
 
 // Headers
-#include <map>
 #include <list>
 #include <vector>
 #include "type.h"
@@ -84,8 +83,17 @@ const unsigned char DATA_END = 24;
 // Forward function declaration
 class Function;
 
+// Grammar
+//   functions are kept in a table indexed by their byte identifier, which
+//   holds the function definition as well as an optional handler (a member
+//   function of the derived grammar, called instead of executeFunction).
+//   Functions report errors through fail() rather than by throwing, so the
+//   non-throwing callFunction can be used on hot paths.
 class Grammar {
 public:
+    // Function handler
+    typedef Value (Grammar::*Handler)(const Parameters&);
+
     // Construction and destruction
     Grammar();
     ~Grammar();
@@ -101,8 +109,10 @@ public:
     const Function* getFunction(unsigned char) const;
     void deleteFunction(unsigned char);
     std::string nameFunction(unsigned char) const;
-    Value callFunction(unsigned char, const std::vector<Value>&);
-    virtual Value executeFunction(unsigned char, const std::vector<Value>&);
+    Value callFunction(unsigned char, const Parameters&);
+    Value callFunction(const Function*, unsigned char, const Parameters&);
+    bool callFunction(const Function*, unsigned char, const Parameters&, Value&, Error&);
+    virtual Value executeFunction(unsigned char, const Parameters&);
 
     // Test funcions
     bool isReserved(unsigned char) const;
@@ -111,9 +121,24 @@ public:
     bool isData(unsigned char) const;
     bool isFunction(unsigned char) const;
 
+protected:
+    // Handler registration
+    void setHandler(unsigned char, Handler);
+
+    // Error reporting
+    Value fail(EXCEPTIONTYPE, const char*);
+
 private:
+    // Dispatch table entry
+    struct Entry {
+        const Function* function;
+        Handler handler;
+    };
+
     bool mSetup;
-    std::map<unsigned char, const Function*> mFunctions;
+    Entry mFunctions[256];
+    bool mFailed;
+    Error mError;
     std::list<const Function*> mCreatedFunctions;
 };
 
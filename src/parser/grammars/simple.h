@@ -48,38 +48,39 @@ public:
     // Grammar setup
     virtual void setup();
     virtual void block();
-    virtual Value executeFunction(unsigned char, const std::vector<Value>&);
 
 protected:
     // Variable handling
-    Value get(std::vector<Value>);
-    Value set(std::vector<Value>);
+    Value get(const Parameters&);
+    Value set(const Parameters&);
 
     // Mathematical
-    Value plus(std::vector<Value>);
-    Value min(std::vector<Value>);
-    Value mult(std::vector<Value>);
-    Value div(std::vector<Value>);
-    Value mod(std::vector<Value>);
+    Value plus(const Parameters&);
+    Value min(const Parameters&);
+    Value mult(const Parameters&);
+    Value div(const Parameters&);
+    Value mod(const Parameters&);
 
     // Tests
-    Value equals(std::vector<Value>);
-    Value inequals(std::vector<Value>);
-    Value greater(std::vector<Value>);
-    Value strictgreater(std::vector<Value>);
-    Value lesser(std::vector<Value>);
-    Value strictlesser(std::vector<Value>);
+    Value equals(const Parameters&);
+    Value inequals(const Parameters&);
+    Value greater(const Parameters&);
+    Value strictgreater(const Parameters&);
+    Value lesser(const Parameters&);
+    Value strictlesser(const Parameters&);
 
     // Random data generators
-    Value rand_bool(std::vector<Value>);
-    Value rand_int(std::vector<Value>);
+    Value rand_bool(const Parameters&);
+    Value rand_int(const Parameters&);
 
     // Other
-    Value print(std::vector<Value>);
+    Value print(const Parameters&);
 
 private:
-    unsigned char setPointer(Value (SimpleGrammar::*)(std::vector<Value>), std::string, std::initializer_list<Type>, Type);
-    std::map<unsigned char, Value (SimpleGrammar::*)(std::vector<Value>)> mPointers;
+    unsigned char setPointer(Value (SimpleGrammar::*)(const Parameters&), std::string, std::initializer_list<Type>, Type);
+
+    // Variable scope (per instance, so grammars can run concurrently)
+    std::map<unsigned int, Value> mScope;
 };
 
 
@@ -91,22 +92,19 @@ private:
 // Variable handling
 //
 
-// Static scope
-std::map<unsigned int, Value> mScope;
-
 unsigned char GET;
-Value SimpleGrammar::get(std::vector<Value> p) {
+Value SimpleGrammar::get(const Parameters& p) {
     // The variable must be defined
     std::map<unsigned int, Value>::const_iterator it = mScope.find(p[0].getInt());
     if (it == mScope.end()) {
-        throw Exception(FUNCTION, "unknown variable");
+        return fail(FUNCTION, "unknown variable");
     }
 
     return it->second;
 }
 
 unsigned char SET;
-Value SimpleGrammar::set(std::vector<Value> p) {
+Value SimpleGrammar::set(const Parameters& p) {
     // Define the variable
     mScope[p[0].getInt()] = p[1];
 
@@ -119,49 +117,43 @@ Value SimpleGrammar::set(std::vector<Value> p) {
 //
 
 // Save the function locally
-unsigned char SimpleGrammar::setPointer(Value (SimpleGrammar::*iPointer)(std::vector<Value>), std::string iName, std::initializer_list<Type> iParameters, Type iReturn) {
+unsigned char SimpleGrammar::setPointer(Value (SimpleGrammar::*iPointer)(const Parameters&), std::string iName, std::initializer_list<Type> iParameters, Type iReturn) {
     unsigned char tByte;
     tByte = createFunction(iName, std::vector<Type>(iParameters), iReturn);
-    mPointers[tByte] = iPointer;
+    setHandler(tByte, static_cast<Handler>(iPointer));
     return tByte;
 }
 
-// Execute a function
-Value SimpleGrammar::executeFunction(unsigned char iByte, const std::vector<Value>& iParameters) {
-    // Have we got a function definition?
-    std::map<unsigned char, Value (SimpleGrammar::*)(std::vector<Value>)>::iterator it = mPointers.find(iByte);
-    if (it != mPointers.end())
-        return ((this)->*(mPointers[iByte]))(iParameters);
-    else
-        return SimpleGrammar::executeFunction(iByte, iParameters);
-}
-
 //
 // Mathematical
 //
 
 unsigned char MATH_PLUS;
-Value SimpleGrammar::plus(std::vector<Value> p) {
+Value SimpleGrammar::plus(const Parameters& p) {
     return p[0].getInt() + p[1].getInt();
 }
 
 unsigned char MATH_MIN;
-Value SimpleGrammar::min(std::vector<Value> p) {
+Value SimpleGrammar::min(const Parameters& p) {
     return p[0].getInt() - p[1].getInt();
 }
 
 unsigned char MATH_MULT;
-Value SimpleGrammar::mult(std::vector<Value> p) {
+Value SimpleGrammar::mult(const Parameters& p) {
     return p[0].getInt() * p[1].getInt();
 }
 
 unsigned char MATH_DIV;
-Value SimpleGrammar::div(std::vector<Value> p) {
+Value SimpleGrammar::div(const Parameters& p) {
+    if (p[1].getInt() == 0)
+        return fail(FUNCTION, "division by zero");
     return p[0].getInt() / p[1].getInt();
 }
 
 unsigned char MATH_MOD;
-Value SimpleGrammar::mod(std::vector<Value> p) {
+Value SimpleGrammar::mod(const Parameters& p) {
+    if (p[1].getInt() == 0)
+        return fail(FUNCTION, "division by zero");
     return p[0].getInt() % p[1].getInt();
 }
 
@@ -171,32 +163,32 @@ Value SimpleGrammar::mod(std::vector<Value> p) {
 //
 
 unsigned char TEST_EQUALS;
-Value SimpleGrammar::equals(std::vector<Value> p) {
+Value SimpleGrammar::equals(const Parameters& p) {
     return p[0].getInt() == p[1].getInt();
 }
 
 unsigned char TEST_INEQUALS;
-Value SimpleGrammar::inequals(std::vector<Value> p) {
+Value SimpleGrammar::inequals(const Parameters& p) {
     return p[0].getInt() != p[1].getInt();
 }
 
 unsigned char TEST_LESSER;
-Value SimpleGrammar::lesser(std::vector<Value> p) {
+Value SimpleGrammar::lesser(const Parameters& p) {
     return p[0].getInt() <= p[1].getInt();
 }
 
 unsigned char TEST_STRICTLESSER;
-Value SimpleGrammar::strictlesser(std::vector<Value> p) {
+Value SimpleGrammar::strictlesser(const Parameters& p) {
     return p[0].getInt() < p[1].getInt();
 }
 
 unsigned char TEST_GREATER;
-Value SimpleGrammar::greater(std::vector<Value> p) {
+Value SimpleGrammar::greater(const Parameters& p) {
     return p[0].getInt() >= p[1].getInt();
 }
 
 unsigned char TEST_STRICTGREATER;
-Value SimpleGrammar::strictgreater(std::vector<Value> p) {
+Value SimpleGrammar::strictgreater(const Parameters& p) {
     return p[0].getInt() > p[1].getInt();
 }
 
@@ -206,12 +198,12 @@ Value SimpleGrammar::strictgreater(std::vector<Value> p) {
 //
 
 unsigned char RAND_BOOL;
-Value SimpleGrammar::rand_bool(std::vector<Value> p) {
+Value SimpleGrammar::rand_bool(const Parameters& p) {
     return Value(random_int(0, 2) == 1);
 }
 
 unsigned char RAND_INT;
-Value SimpleGrammar::rand_int(std::vector<Value> p) {
+Value SimpleGrammar::rand_int(const Parameters& p) {
     return Value(random_int(p[0].getInt(), p[1].getInt()));
 }
 
@@ -221,7 +213,7 @@ Value SimpleGrammar::rand_int(std::vector<Value> p) {
 //
 
 unsigned char OTHER_PRINT;
-Value SimpleGrammar::print(std::vector<Value> p) {
+Value SimpleGrammar::print(const Parameters& p) {
     std::cout << "Print: " << p[0].getInt() << std::endl;
     return Value();
 }
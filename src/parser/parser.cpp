@@ -46,12 +46,16 @@ Parser::Parser(Grammar* iGrammar, unsigned long iInstructions) {
     mGrammar = iGrammar;
     mInstructionLimit = true;
     mInstructions = iInstructions;
+    mDetailed = false;
+    mCacheCapacity = PARSER_CACHE;
 }
 
 // Parameterized constructor
 Parser::Parser(Grammar* iGrammar) {
     mGrammar = iGrammar;
     mInstructionLimit = false;
+    mDetailed = false;
+    mCacheCapacity = PARSER_CACHE;
 }
 
 
@@ -60,112 +64,190 @@ Parser::Parser(Grammar* iGrammar) {
 // Main functionality
 //
 
-// Evaluate DNA
+// Validate DNA
 void Parser::validate(const DNA& iDNA) {
+    Error tError;
+    if (!validate(iDNA, tError))
+        throw tError.exception();
+}
+
+// Validate DNA, without throwing
+bool Parser::validate(const DNA& iDNA, Error& oError) {
     // Reset the quotum
     mInstructionCounter = 0;
 
     // Validate all blocks
     for (unsigned int i = 0; i < iDNA.genes(); i++) {
-        // Extract the blocks
-        unsigned char* tGene;
-        unsigned int tSize;
-        iDNA.extract_gene(i, tGene, tSize);
-
-        // Evaluate the block
-        validate_block(tGene, tSize);
+        // Get the block
+        Gene tGene = iDNA.gene(i);
 
-        // Free the block
-        free(tGene);
+        // Validate the block
+        if (!validate_block(tGene.data, tGene.size)) {
+            oError = mError;
+            return false;
+        }
     }
+    return true;
 }
 
-
-
 // Evaluate DNA
+//   compiles the DNA and executes it once; when the same DNA needs to be
+//   evaluated repeatedly, compile it once and execute the program instead
 void Parser::evaluate(const DNA& iDNA) {
+    execute(compile(iDNA));
+}
+
+// Compile DNA into a program
+Program Parser::compile(const DNA& iDNA) {
+    Program tProgram;
+    Error tError;
+    if (!compile(iDNA, tProgram, tError))
+        throw tError.exception();
+    return tProgram;
+}
+
+// Compile DNA into a program, without throwing
+bool Parser::compile(const DNA& iDNA, Program& oProgram, Error& oError) {
     // Reset the quotum
     mInstructionCounter = 0;
-    
-    // Evaluate all blocks
+
+    // Compile all blocks
+    oProgram.clear();
     for (unsigned int i = 0; i < iDNA.genes(); i++) {
-        // Extract the blocks
-        unsigned char* tGene;
-        unsigned int tSize;
-        iDNA.extract_gene(i, tGene, tSize);
+        // Get the block
+        Gene tGene = iDNA.gene(i);
+
+        // Look for a cached version, and account for the instructions its
+        // validation would have taken
+        uint64_t tHash = DNA::hash(tGene.data, tGene.size);
+        unsigned long tInstructions;
+        const std::shared_ptr<const Block>* tCached = cache_lookup(tHash, tGene.data, tGene.size, tInstructions);
+        if (tCached != 0) {
+            if (mInstructionLimit && mInstructionCounter + tInstructions >= mInstructions) {
+                oError = Error(GENERIC, "instruction quotum reacher");
+                return false;
+            }
+            mInstructionCounter += tInstructions;
+            oProgram.addBlock(*tCached);
+            continue;
+        }
 
-        // Evaluate the block
-        evaluate_block(tGene, tSize);
+        // Validate the block, so the compilation helpers can assume proper syntax
+        unsigned long tCounter = mInstructionCounter;
+        if (!validate_block(tGene.data, tGene.size)) {
+            oError = mError;
+            return false;
+        }
 
-        // Free the block
-        free(tGene);
+        // Compile the block
+        std::shared_ptr<const Block> tBlock = compile_block(tGene.data, tGene.size);
+        cache_store(tHash, tGene.data, tGene.size, mInstructionCounter - tCounter, tBlock);
+        oProgram.addBlock(tBlock);
     }
+
+    return true;
+}
+
+// Execute a compiled program
+//   function errors get thrown with the details the checks of the failing
+//   function provide
+void Parser::execute(const Program& iProgram) {
+    mDetailed = true;
+    Error tError;
+    if (!execute_program(iProgram, tError))
+        throw tError.exception();
+}
+
+// Execute a compiled program, without throwing
+bool Parser::execute(const Program& iProgram, Error& oError) {
+    mDetailed = false;
+    return execute_program(iProgram, oError);
 }
 
 // Output the DNA
 void Parser::print(std::ostream& iStream, const DNA& iDNA) {
     for (unsigned int i = 0; i < iDNA.genes(); i++) {
-        // Extract the gene
-        unsigned char* tGene;
-        unsigned int tSize;
-        iDNA.extract_gene(i, tGene, tSize);
+        // Get the gene
+        Gene tGene = iDNA.gene(i);
 
         // Print the block
         std::cout << "* Human-readable version of block " << i << std::endl;
-        print_block(iStream, tGene, tSize);
+        print_block(iStream, tGene.data, tGene.size);
+    }
+}
+
 
-        // Free the block
-        free(tGene);
+
+//
+// Configuration
+//
+
+// Set the amount of compiled blocks to cache (0 disables caching)
+void Parser::setCache(unsigned int iCapacity) {
+    mCacheCapacity = iCapacity;
+    while (mCacheOrder.size() > mCacheCapacity) {
+        mCache.erase(mCacheOrder.front());
+        mCacheOrder.pop_front();
     }
 }
 
+
 //
 // Validation helpers
 //
 
-void Parser::validate_block(unsigned char* iBlock, unsigned int iSize) {
+bool Parser::validate_block(const unsigned char* iBlock, unsigned int iSize) {
     // Extract all instructions
     unsigned int tLoc = 0;
+    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode;
+    if (!extract_instructions(iBlock, iSize, tLoc, tInstructionBytecode))
+        return false;
 
     // Validate all instructions
-    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
     for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-        validate_instruction(iBlock, iSize, tInstructionBytecode[i].first);
+        if (!validate_instruction(iBlock, iSize, tInstructionBytecode[i].first))
+            return false;
         if (tInstructionBytecode[i].first != tInstructionBytecode[i].second)
-            throw Exception(SYNTAX, "garbage after instruction");
+            return fail(SYNTAX, "garbage after instruction");
     }
 
     if (tLoc < iSize)
-        throw Exception(SYNTAX, "garbage after block");
+        return fail(SYNTAX, "garbage after block");
+    return true;
 }
 
-void Parser::validate_instruction(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
-    tick();
+bool Parser::validate_instruction(const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+    if (!tick())
+        return false;
 
     // Conditional
     if (mGrammar->isConditional(iBlock[tLoc]))
-        validate_conditional(iBlock, iSize, tLoc);
+        return validate_conditional(iBlock, iSize, tLoc);
 
     // Function
     else if (mGrammar->isFunction(iBlock[tLoc]))
-        validate_function(iBlock, iSize, tLoc);
+        return validate_function(iBlock, iSize, tLoc);
 
     // Data
     else if (mGrammar->isData(iBlock[tLoc]))
         return validate_data(iBlock, iSize, tLoc);
-    
+
     // Unknown
     else
-        throw Exception(SYNTAX, "unknown byte identifier");
+        return fail(SYNTAX, "unknown byte identifier");
 }
 
-void Parser::validate_conditional(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+bool Parser::validate_conditional(const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
     // Save conditional for later evaluation
     unsigned char tConditional = iBlock[tLoc++];
 
     // Extract tests and instructions
-    std::vector<std::pair<unsigned int, unsigned int> > tTestBytecode = extract_arguments(iBlock, iSize, tLoc);
-    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
+    std::vector<std::pair<unsigned int, unsigned int> > tTestBytecode;
+    if (!extract_arguments(iBlock, iSize, tLoc, tTestBytecode))
+        return false;
+    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode;
+    if (!extract_instructions(iBlock, iSize, tLoc, tInstructionBytecode))
+        return false;
     if (tInstructionBytecode.size() > 0)
         tLoc = tInstructionBytecode.back().second + 1;
 
@@ -173,8 +255,9 @@ void Parser::validate_conditional(unsigned char* iBlock, unsigned int iSize, uns
     std::vector<std::pair<unsigned int, unsigned int> > tElseInstructionBytecode;
     if (iBlock[tLoc] == COND_ELSE) {
         tLoc++;
-        tElseInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
-        
+        if (!extract_instructions(iBlock, iSize, tLoc, tElseInstructionBytecode))
+            return false;
+
         if (tElseInstructionBytecode.size() > 0)
             tLoc = tElseInstructionBytecode.back().second + 1;
     }
@@ -188,129 +271,134 @@ void Parser::validate_conditional(unsigned char* iBlock, unsigned int iSize, uns
         {
             // Validate tests
             if (tTestBytecode.size() != 1)
-                throw Exception(SYNTAX, "conditional only accepts one test");
-            validate_instruction(iBlock, iSize, tTestBytecode[0].first);
+                return fail(SYNTAX, "conditional only accepts one test");
+            if (!validate_instruction(iBlock, iSize, tTestBytecode[0].first))
+                return false;
             if (tTestBytecode[0].first != tTestBytecode[0].second)
-                throw Exception(SYNTAX, "garbage after test");
+                return fail(SYNTAX, "garbage after test");
 
             // Validate instruction block
             for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-                validate_instruction(iBlock, iSize, tInstructionBytecode[i].first);
+                if (!validate_instruction(iBlock, iSize, tInstructionBytecode[i].first))
+                    return false;
                 if (tInstructionBytecode[i].first != tInstructionBytecode[i].second)
-                    throw Exception(SYNTAX, "garbage after instruction");
+                    return fail(SYNTAX, "garbage after instruction");
             }
 
             // Validate else-instruction block
             for (unsigned int i = 0; i < tElseInstructionBytecode.size(); i++) {
-                validate_instruction(iBlock, iSize, tElseInstructionBytecode[i].first);
+                if (!validate_instruction(iBlock, iSize, tElseInstructionBytecode[i].first))
+                    return false;
                 if (tElseInstructionBytecode[i].first != tElseInstructionBytecode[i].second)
-                    throw Exception(SYNTAX, "garbage after else-instruction");
+                    return fail(SYNTAX, "garbage after else-instruction");
             }
 
-            break;
+            return true;
         }
 
         case COND_ELSE:
         {
-            throw Exception(GENERIC, "else-conditional cannot exist by itself");
+            return fail(GENERIC, "else-conditional cannot exist by itself");
         }
 
         default:
         {
-            throw Exception(GENERIC, "conditional clause not implemented");
+            return fail(GENERIC, "conditional clause not implemented");
         }
     }
 }
 
-void Parser::validate_function(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+bool Parser::validate_function(const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
     // Fetch the function
     unsigned char tFunctionBytecode = iBlock[tLoc++];
 
     // Validate function
     if (!mGrammar->isFunction(tFunctionBytecode))
-        throw Exception(SYNTAX, "unknown function");
+        return fail(SYNTAX, "unknown function");
     const Function* tFunction = mGrammar->getFunction(tFunctionBytecode);
 
     // Validate parameter count
-    std::vector<std::pair<unsigned int, unsigned int> > tParameterBytecode = extract_arguments(iBlock, iSize, tLoc);
+    std::vector<std::pair<unsigned int, unsigned int> > tParameterBytecode;
+    if (!extract_arguments(iBlock, iSize, tLoc, tParameterBytecode))
+        return false;
     if (tParameterBytecode.size() != tFunction->getParameterCount())
-        throw Exception(SYNTAX, "invalid function parameter count");
+        return fail(SYNTAX, "invalid function parameter count");
 
     // Validate parameter syntax
     for (unsigned int i = 0; i < tParameterBytecode.size(); i++) {
-        validate_instruction(iBlock, iSize, tParameterBytecode[i].first);
+        if (!validate_instruction(iBlock, iSize, tParameterBytecode[i].first))
+            return false;
         if (tParameterBytecode[i].first != tParameterBytecode[i].second)
-            throw Exception(SYNTAX, "garbage after parameter");
+            return fail(SYNTAX, "garbage after parameter");
     }
 
     
     if (tParameterBytecode.size() > 0)
         tLoc = tParameterBytecode.back().second + 1;
+    return true;
 }
 
-void Parser::validate_data(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+bool Parser::validate_data(const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
     unsigned char tDataType = iBlock[tLoc++];
     switch (tDataType) {
         case DATA_VOID:
-            break;
+            return true;
 
         case DATA_BOOL:
         case DATA_INT:
             if (tLoc >= iSize)
-                throw Exception(SYNTAX, "boolean type needs 1 byte of data");
+                return fail(SYNTAX, "boolean type needs 1 byte of data");
             tLoc++;
-            break;
+            return true;
 
         default:
-            throw Exception(SYNTAX, "unknown datatype");
+            return fail(SYNTAX, "unknown datatype");
     }
 }
 
 //
-// Evaluation helpers
+// Compilation helpers
+//   these only get to see validated code, and need not check for errors
 //
 
-void Parser::evaluate_block(unsigned char* iBlock, unsigned int iSize) {
+std::shared_ptr<const Block> Parser::compile_block(const unsigned char* iBlock, unsigned int iSize) {
     // Extract all instructions
     unsigned int tLoc = 0;
-    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
-
-    // Give the grammar a chance to do some stuff (variable handling, ...)
-    mGrammar->block();
-
-    // Evaluate all instructions
-    for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-        evaluate_instruction(iBlock, iSize, tInstructionBytecode[i].first);
-    }
+    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode;
+    extract_instructions(iBlock, iSize, tLoc, tInstructionBytecode);
+
+    // Compile all instructions
+    std::shared_ptr<Block> tCompiled(new Block());
+    std::vector<unsigned int> tInstructions;
+    for (unsigned int i = 0; i < tInstructionBytecode.size(); i++)
+        tInstructions.push_back(compile_instruction(*tCompiled, iBlock, iSize, tInstructionBytecode[i].first));
+    tCompiled->setInstructions(tInstructions);
+    return tCompiled;
 }
 
-Value Parser::evaluate_instruction(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
-    tick();
-    
+unsigned int Parser::compile_instruction(Block& oCompiled, const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
     // Conditional
-    if (mGrammar->isConditional(iBlock[tLoc])) {
-        evaluate_conditional(iBlock, iSize, tLoc);
-        return Value();
-    }
+    if (mGrammar->isConditional(iBlock[tLoc]))
+        return compile_conditional(oCompiled, iBlock, iSize, tLoc);
 
     // Function
     else if (mGrammar->isFunction(iBlock[tLoc]))
-        return evaluate_function(iBlock, iSize, tLoc);
-
-    // Data
-    else if (mGrammar->isData(iBlock[tLoc]))
-        return evaluate_data(iBlock, iSize, tLoc);
+        return compile_function(oCompiled, iBlock, iSize, tLoc);
 
-    return Value();
+    // Data (the only option left in validated code)
+    else
+        return compile_data(oCompiled, iBlock, iSize, tLoc);
 }
 
-void Parser::evaluate_conditional(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+unsigned int Parser::compile_conditional(Block& oCompiled, const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
     // Save conditional for later evaluation
     unsigned char tConditional = iBlock[tLoc++];
 
     // Extract tests and instructions
-    std::vector<std::pair<unsigned int, unsigned int> > tTestBytecode = extract_arguments(iBlock, iSize, tLoc);
-    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
+    std::vector<std::pair<unsigned int, unsigned int> > tTestBytecode;
+    extract_arguments(iBlock, iSize, tLoc, tTestBytecode);
+    std::vector<std::pair<unsigned int, unsigned int> > tInstructionBytecode;
+    extract_instructions(iBlock, iSize, tLoc, tInstructionBytecode);
     if (tInstructionBytecode.size() > 0)
         tLoc = tInstructionBytecode.back().second + 1;
 
@@ -318,30 +406,163 @@ void Parser::evaluate_conditional(unsigned char* iBlock, unsigned int iSize, uns
     std::vector<std::pair<unsigned int, unsigned int> > tElseInstructionBytecode;
     if (iBlock[tLoc] == COND_ELSE) {
         tLoc++;
-        tElseInstructionBytecode = extract_instructions(iBlock, iSize, tLoc);
+        extract_instructions(iBlock, iSize, tLoc, tElseInstructionBytecode);
 
         if (tElseInstructionBytecode.size() > 0)
             tLoc = tElseInstructionBytecode.back().second + 1;
     }
 
+    // Compile the test, the instructions and the else-instructions
+    std::vector<unsigned int> tChildren;
+    tChildren.push_back(compile_instruction(oCompiled, iBlock, iSize, tTestBytecode[0].first));
+    for (unsigned int i = 0; i < tInstructionBytecode.size(); i++)
+        tChildren.push_back(compile_instruction(oCompiled, iBlock, iSize, tInstructionBytecode[i].first));
+    for (unsigned int i = 0; i < tElseInstructionBytecode.size(); i++)
+        tChildren.push_back(compile_instruction(oCompiled, iBlock, iSize, tElseInstructionBytecode[i].first));
+
+    // Create the node
+    Block::Node tNode;
+    tNode.type = NODE_CONDITIONAL;
+    tNode.byte = tConditional;
+    tNode.function = 0;
+    tNode.size = tChildren.size();
+    tNode.alternatives = tElseInstructionBytecode.size();
+    tNode.children = oCompiled.addChildren(tChildren);
+    return oCompiled.addNode(tNode);
+}
+
+unsigned int Parser::compile_function(Block& oCompiled, const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+    // Fetch the function
+    unsigned char tFunction = iBlock[tLoc++];
+
+    // Compile all arguments
+    std::vector<std::pair<unsigned int, unsigned int> > tParameterBytecode;
+    extract_arguments(iBlock, iSize, tLoc, tParameterBytecode);
+    std::vector<unsigned int> tChildren;
+    for (unsigned int i = 0; i < tParameterBytecode.size(); i++)
+        tChildren.push_back(compile_instruction(oCompiled, iBlock, iSize, tParameterBytecode[i].first));
+    if (tParameterBytecode.size() > 0)
+        tLoc = tParameterBytecode.back().second + 1;
+
+    // Create the node
+    Block::Node tNode;
+    tNode.type = NODE_FUNCTION;
+    tNode.byte = tFunction;
+    tNode.function = mGrammar->getFunction(tFunction);
+    tNode.size = tChildren.size();
+    tNode.alternatives = 0;
+    tNode.children = oCompiled.addChildren(tChildren);
+    return oCompiled.addNode(tNode);
+}
+
+unsigned int Parser::compile_data(Block& oCompiled, const unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
+    Block::Node tNode;
+    tNode.type = NODE_DATA;
+    tNode.byte = iBlock[tLoc++];
+    tNode.function = 0;
+    tNode.children = 0;
+    tNode.size = 0;
+    tNode.alternatives = 0;
+    switch (tNode.byte) {
+        case DATA_VOID:
+        {
+            tNode.value = VOID;
+            break;
+        }
+        case DATA_BOOL:
+        {
+            tNode.value = toBool(iBlock[tLoc++]);
+            break;
+        }
+        case DATA_INT:
+        {
+            tNode.value = toInt(iBlock[tLoc++]);
+            break;
+        }
+    }
+    return oCompiled.addNode(tNode);
+}
+
+//
+// Execution helpers
+//
+
+bool Parser::execute_program(const Program& iProgram, Error& oError) {
+    // Reset the quotum and the stack (which an error might have left behind)
+    mInstructionCounter = 0;
+    mStack.clear();
+
+    // Execute all blocks
+    Value tResult;
+    for (unsigned int i = 0; i < iProgram.blocks(); i++) {
+        const Block& tBlock = iProgram.getBlock(i);
+
+        // Give the grammar a chance to do some stuff (variable handling, ...)
+        mGrammar->block();
+
+        // Execute all instructions
+        for (unsigned int j = 0; j < tBlock.instructions(); j++) {
+            if (!execute_instruction(tBlock, tBlock.getInstruction(j), tResult)) {
+                oError = mError;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Parser::execute_instruction(const Block& iCompiled, unsigned int iNode, Value& oResult) {
+    if (!tick())
+        return false;
+
+    const Block::Node& tNode = iCompiled.getNode(iNode);
+    switch (tNode.type) {
+        // Conditional
+        case NODE_CONDITIONAL:
+            oResult = Value();
+            return execute_conditional(iCompiled, tNode);
+
+        // Function
+        case NODE_FUNCTION:
+            return execute_function(iCompiled, tNode, oResult);
+
+        // Data
+        case NODE_DATA:
+            oResult = tNode.value;
+            return true;
+    }
+
+    oResult = Value();
+    return true;
+}
+
+bool Parser::execute_conditional(const Block& iCompiled, const Block::Node& iNode) {
+    // Locate the test, the instructions and the else-instructions
+    unsigned int tTest = iCompiled.getChild(iNode.children);
+    unsigned int tInstructions = iNode.children + 1;
+    unsigned int tInstructionCount = iNode.size - 1 - iNode.alternatives;
+    unsigned int tElseInstructions = tInstructions + tInstructionCount;
+
     // Check the evaluation type
-    switch (tConditional) {
+    Value tResult;
+    switch (iNode.byte) {
         case COND_IF:
         {
             // Evaluate the parameter
-            Value tTest = evaluate_instruction(iBlock, iSize, tTestBytecode[0].first);
-            if (tTest.getType() != BOOL)
-                throw Exception(CONDITIONAL, "test passed to 'if' did not produce boolean value");
+            if (!execute_instruction(iCompiled, tTest, tResult))
+                return false;
+            if (tResult.getType() != BOOL)
+                return fail(CONDITIONAL, "test passed to 'if' did not produce boolean value");
 
             // Evaluate the instructions
-            if (tTest.getBool()) {
-                for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-                    evaluate_instruction(iBlock, iSize, tInstructionBytecode[i].first);
-                }
+            if (tResult.getBool()) {
+                for (unsigned int i = 0; i < tInstructionCount; i++)
+                    if (!execute_instruction(iCompiled, iCompiled.getChild(tInstructions + i), tResult))
+                        return false;
             } else {
-                for (unsigned int i = 0; i < tElseInstructionBytecode.size(); i++) {
-                    evaluate_instruction(iBlock, iSize, tElseInstructionBytecode[i].first);
-                }
+                for (unsigned int i = 0; i < iNode.alternatives; i++)
+                    if (!execute_instruction(iCompiled, iCompiled.getChild(tElseInstructions + i), tResult))
+                        return false;
             }
             break;
         }
@@ -349,19 +570,20 @@ void Parser::evaluate_conditional(unsigned char* iBlock, unsigned int iSize, uns
         case COND_UNLESS:
         {
             // Evaluate the parameter
-            Value tTest = evaluate_instruction(iBlock, iSize, tTestBytecode[0].first);
-            if (tTest.getType() != BOOL)
-                throw Exception(CONDITIONAL, "test passed to 'unless' did not produce boolean value");
+            if (!execute_instruction(iCompiled, tTest, tResult))
+                return false;
+            if (tResult.getType() != BOOL)
+                return fail(CONDITIONAL, "test passed to 'unless' did not produce boolean value");
 
             // Evaluate the instructions
-            if (! tTest.getBool()) {
-                for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-                    evaluate_instruction(iBlock, iSize, tInstructionBytecode[i].first);
-                }
+            if (! tResult.getBool()) {
+                for (unsigned int i = 0; i < tInstructionCount; i++)
+                    if (!execute_instruction(iCompiled, iCompiled.getChild(tInstructions + i), tResult))
+                        return false;
             } else {
-                for (unsigned int i = 0; i < tElseInstructionBytecode.size(); i++) {
-                    evaluate_instruction(iBlock, iSize, tElseInstructionBytecode[i].first);
-                }
+                for (unsigned int i = 0; i < iNode.alternatives; i++)
+                    if (!execute_instruction(iCompiled, iCompiled.getChild(tElseInstructions + i), tResult))
+                        return false;
             }
             break;
         }
@@ -370,17 +592,16 @@ void Parser::evaluate_conditional(unsigned char* iBlock, unsigned int iSize, uns
         {
             while (1) {
                 // Evaluate the parameter
-                unsigned int tLocCond = tTestBytecode[0].first;
-                Value tTest = evaluate_instruction(iBlock, iSize, tLocCond);
-                if (tTest.getType() != BOOL)
-                    throw Exception(CONDITIONAL, "test passed to 'while' did not produce boolean value");
+                if (!execute_instruction(iCompiled, tTest, tResult))
+                    return false;
+                if (tResult.getType() != BOOL)
+                    return fail(CONDITIONAL, "test passed to 'while' did not produce boolean value");
 
                 // Evaluate the instructions
-                if (tTest.getBool()) {
-                    for (unsigned int i = 0; i < tInstructionBytecode.size(); i++) {
-                        unsigned int tLocInst = tInstructionBytecode[i].first;
-                        evaluate_instruction(iBlock, iSize, tLocInst);
-                    }
+                if (tResult.getBool()) {
+                    for (unsigned int i = 0; i < tInstructionCount; i++)
+                        if (!execute_instruction(iCompiled, iCompiled.getChild(tInstructions + i), tResult))
+                            return false;
                 } else {
                     break;
                 }
@@ -388,47 +609,66 @@ void Parser::evaluate_conditional(unsigned char* iBlock, unsigned int iSize, uns
             break;
         }
     }
+    return true;
 }
 
-Value Parser::evaluate_function(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
-    // Fetch the function
-    unsigned char tFunction = iBlock[tLoc++];
-
-    // Evaluate all arguments
-    std::vector<std::pair<unsigned int, unsigned int> > tParameterBytecode = extract_arguments(iBlock, iSize, tLoc);
-    std::vector<Value> tParameters;
-    for (unsigned int i = 0; i < tParameterBytecode.size(); i++) {
-        Value tParameter = evaluate_instruction(iBlock, iSize, tParameterBytecode[i].first);
+bool Parser::execute_function(const Block& iCompiled, const Block::Node& iNode, Value& oResult) {
+    // Evaluate all arguments onto the stack
+    unsigned int tBase = mStack.size();
+    Value tParameter;
+    for (unsigned int i = 0; i < iNode.size; i++) {
+        if (!execute_instruction(iCompiled, iCompiled.getChild(iNode.children + i), tParameter))
+            return false;
         if (tParameter.getType() == VOID)
-            throw Exception(FUNCTION, "function parameter returned void");
-        tParameters.push_back(tParameter);
+            return fail(FUNCTION, "function parameter returned void");
+        mStack.push_back(tParameter);
     }
 
-    // Call the function
-    if (tParameterBytecode.size() > 0)
-        tLoc = tParameterBytecode.back().second + 1;
-    return mGrammar->callFunction(tFunction, tParameters);
+    // Call the function (throwing when asked for details), and pop the arguments
+    Parameters tParameters(mStack.data() + tBase, iNode.size);
+    if (mDetailed)
+        oResult = mGrammar->callFunction(iNode.function, iNode.byte, tParameters);
+    else if (!mGrammar->callFunction(iNode.function, iNode.byte, tParameters, oResult, mError))
+        return false;
+    mStack.resize(tBase);
+    return true;
 }
 
-Value Parser::evaluate_data(unsigned char* iBlock, unsigned int iSize, unsigned int& tLoc) {
-    unsigned char tDataType = iBlock[tLoc++];
-    switch (tDataType) {
-        case DATA_VOID:
-        {
-            return VOID;
-            break;
-        }
-        case DATA_BOOL:
-        {
-            return toBool(iBlock[tLoc++]);
-            break;
-        }
-        case DATA_INT:
-        {
-            return toInt(iBlock[tLoc++]);
-            break;
+
+//
+// Cache helpers
+//
+
+// Look up a compiled block, and the amount of instructions its validation took
+const std::shared_ptr<const Block>* Parser::cache_lookup(uint64_t iHash, const unsigned char* iBlock, unsigned int iSize, unsigned long& oInstructions) {
+    std::unordered_map<uint64_t, CacheEntry>::const_iterator it = mCache.find(iHash);
+    if (it == mCache.end() || it->second.gene.size() != iSize || !std::equal(iBlock, iBlock + iSize, it->second.gene.begin()))
+        return 0;
+    oInstructions = it->second.instructions;
+    return &it->second.block;
+}
+
+// Store a compiled block
+//   a colliding entry gets replaced, and when the cache is full the oldest
+//   entry is evicted
+void Parser::cache_store(uint64_t iHash, const unsigned char* iBlock, unsigned int iSize, unsigned long iInstructions, const std::shared_ptr<const Block>& iCompiled) {
+    if (mCacheCapacity == 0)
+        return;
+
+    // Make room for new entries
+    std::unordered_map<uint64_t, CacheEntry>::iterator it = mCache.find(iHash);
+    if (it == mCache.end()) {
+        if (mCacheOrder.size() >= mCacheCapacity) {
+            mCache.erase(mCacheOrder.front());
+            mCacheOrder.pop_front();
         }
+        mCacheOrder.push_back(iHash);
     }
+
+    CacheEntry& tEntry = mCache[iHash];
+    tEntry.gene.assign(iBlock, iBlock + iSize);
+    tEntry.instructions = iInstructions;
+    tEntry.block = iCompiled;
 }
 
 
@@ -436,7 +676,7 @@ Value Parser::evaluate_data(unsigned char* iBlock, unsigned int iSize, unsigned
 // Output helpers
 //
 
-void Parser::print_block(std::ostream& iStream, unsigned char* iBlock, unsigned int iSize) {
+void Parser::print_block(std::ostream& iStream, const unsigned char* iBlock, unsigned int iSize) {
     unsigned char tIndentation = 1;
     print_indentation(iStream, tIndentation);
 
@@ -541,28 +781,28 @@ void Parser::print_newline(std::ostream& iStream, unsigned int iIndentation) {
 // Auxiliary
 //
 
-inline void Parser::tick() {
+inline bool Parser::tick() {
     if (mInstructionLimit) {
         mInstructionCounter++;
         if (mInstructionCounter == mInstructions)
-            throw Exception(GENERIC, "instruction quotum reacher");
+            return fail(GENERIC, "instruction quotum reacher");
     }
+    return true;
 }
 
-std::vector<std::pair<unsigned int, unsigned int> > Parser::extract_syntax(std::initializer_list<unsigned char> iList, unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc) {
-    // Read syntaxis data
-    if (iList.size() != 3)
-        throw Exception(GENERIC, "syntaxis extraction needs exactly three parameters");
-    unsigned char OPEN = *(iList.begin());
-    unsigned char SEPARATE = *(iList.begin()+1);
-    unsigned char CLOSE = *(iList.begin()+2);
+// Record an error
+inline bool Parser::fail(EXCEPTIONTYPE iType, const char* iMessage) {
+    mError = Error(iType, iMessage);
+    return false;
+}
 
-    // Allocate new container
-    std::vector<std::pair<unsigned int, unsigned int> > tItems;
+bool Parser::extract_syntax(unsigned char OPEN, unsigned char SEPARATE, unsigned char CLOSE, const unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc, std::vector<std::pair<unsigned int, unsigned int> >& oItems) {
+    // Clear the container
+    oItems.clear();
 
     // Find opening arguments bracket
     if (iLoc >= iSize || iBlock[iLoc] != OPEN)
-        throw Exception(SYNTAX, "could not find opening arguments bracket");
+        return fail(SYNTAX, "could not find opening arguments bracket");
 
     // Extract all arguments
     unsigned int tBracketBalance = 0;
@@ -571,33 +811,33 @@ std::vector<std::pair<unsigned int, unsigned int> > Parser::extract_syntax(std::
         if (iBlock[iLoc] == OPEN) {
             tBracketBalance++;
             if (tBracketBalance == 1) {
-                tItems.push_back(std::pair<unsigned int, unsigned int>(iLoc+1, 0));
+                oItems.push_back(std::pair<unsigned int, unsigned int>(iLoc+1, 0));
             }
         }
 
         // Argument separator
         else if (iBlock[iLoc] == SEPARATE) {
             if (tBracketBalance == 1) {
-                if (tItems.size() == 0)
-                    throw Exception(SYNTAX, "item separator cannot occur before any item");
-                else if (tItems.back().second != 0)
-                    throw Exception(SYNTAX, "unexpected separator");
-                tItems.back().second = iLoc;
-                tItems.push_back(std::pair<unsigned int, unsigned int>(iLoc+1, 0));
+                if (oItems.size() == 0)
+                    return fail(SYNTAX, "item separator cannot occur before any item");
+                else if (oItems.back().second != 0)
+                    return fail(SYNTAX, "unexpected separator");
+                oItems.back().second = iLoc;
+                oItems.push_back(std::pair<unsigned int, unsigned int>(iLoc+1, 0));
             }
         }
 
         // End of argument
         else if (iBlock[iLoc] == CLOSE) {
             if (tBracketBalance == 1) {
-                if (tItems.size() != 0) {
-                    if (tItems.back().second != 0)
-                        throw Exception(SYNTAX, "unexpected list end");
-                    tItems.back().second = iLoc;
+                if (oItems.size() != 0) {
+                    if (oItems.back().second != 0)
+                        return fail(SYNTAX, "unexpected list end");
+                    oItems.back().second = iLoc;
 
                     // Manage void function
-                    if (tItems.back().second - tItems.back().first == 0)
-                        tItems.pop_back();
+                    if (oItems.back().second - oItems.back().first == 0)
+                        oItems.pop_back();
                 }
             }
             tBracketBalance--;
@@ -618,19 +858,19 @@ std::vector<std::pair<unsigned int, unsigned int> > Parser::extract_syntax(std::
 
     // Check if the brackets did match
     if (tBracketBalance != 0)
-        throw Exception(SYNTAX, "could not find end of syntaxis list");
+        return fail(SYNTAX, "could not find end of syntaxis list");
 
-    return tItems;
+    return true;
 }
 
 // Extract arguments
-std::vector<std::pair<unsigned int, unsigned int> > Parser::extract_arguments(unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc) {
-    return extract_syntax({ARG_OPEN, ARG_SEP, ARG_CLOSE}, iBlock, iSize, iLoc);
+bool Parser::extract_arguments(const unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc, std::vector<std::pair<unsigned int, unsigned int> >& oItems) {
+    return extract_syntax(ARG_OPEN, ARG_SEP, ARG_CLOSE, iBlock, iSize, iLoc, oItems);
 }
 
 // Extract instructions
-std::vector<std::pair<unsigned int, unsigned int> > Parser::extract_instructions(unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc) {
-    return extract_syntax({INSTR_OPEN, INSTR_SEP, INSTR_CLOSE}, iBlock, iSize, iLoc);
+bool Parser::extract_instructions(const unsigned char* iBlock, unsigned int iSize, unsigned int& iLoc, std::vector<std::pair<unsigned int, unsigned int> >& oItems) {
+    return extract_syntax(INSTR_OPEN, INSTR_SEP, INSTR_CLOSE, iBlock, iSize, iLoc, oItems);
 }
 
 
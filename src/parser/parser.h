@@ -38,14 +38,35 @@
 #include <valarray>
 #include <utility>
 #include <initializer_list>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <algorithm>
 #include "grammar.h"
+#include "program.h"
 #include "../dna.h"
 
 
+//
+// Constants
+//
+
+// Default amount of compiled blocks to cache
+const unsigned int PARSER_CACHE = 1024;
+
+
+
 //////////////////////
 // CLASS DEFINITION //
 //////////////////////
 
+// Parser
+//   every operation comes in two flavours: one throwing an Exception when
+//   something goes wrong, and one reporting an Error instead, which is a lot
+//   cheaper when most of the input is expected to be invalid.
+//   Compiled blocks are cached by gene content, so compiling a mutant only
+//   validates and compiles the genes that actually changed; the cache
+//   assumes the grammar does not change after the parser got created.
 class Parser {
 public:
     // Construction and destruction
@@ -54,34 +75,53 @@ public:
 
     // Main functionality
     void validate(const DNA&);
+    bool validate(const DNA&, Error&);
     void evaluate(const DNA&);
+    Program compile(const DNA&);
+    bool compile(const DNA&, Program&, Error&);
+    void execute(const Program&);
+    bool execute(const Program&, Error&);
     void print(std::ostream&, const DNA&);
 
+    // Configuration
+    void setCache(unsigned int);
+
 private:
     // Validation helpers
-    void validate_block(unsigned char*, unsigned int);
-    void validate_instruction(unsigned char*, unsigned int, unsigned int&);
-    void validate_conditional(unsigned char*, unsigned int, unsigned int&);
-    void validate_function(unsigned char*, unsigned int, unsigned int&);
-    void validate_data(unsigned char*, unsigned int, unsigned int&);
-
-    // Evaluation helpers
-    void evaluate_block(unsigned char*, unsigned int);
-    Value evaluate_instruction(unsigned char*, unsigned int, unsigned int&);
-    void evaluate_conditional(unsigned char*, unsigned int, unsigned int&);
-    Value evaluate_function(unsigned char*, unsigned int, unsigned int&);
-    Value evaluate_data(unsigned char*, unsigned int, unsigned int&);
+    bool validate_block(const unsigned char*, unsigned int);
+    bool validate_instruction(const unsigned char*, unsigned int, unsigned int&);
+    bool validate_conditional(const unsigned char*, unsigned int, unsigned int&);
+    bool validate_function(const unsigned char*, unsigned int, unsigned int&);
+    bool validate_data(const unsigned char*, unsigned int, unsigned int&);
+
+    // Compilation helpers
+    std::shared_ptr<const Block> compile_block(const unsigned char*, unsigned int);
+    unsigned int compile_instruction(Block&, const unsigned char*, unsigned int, unsigned int&);
+    unsigned int compile_conditional(Block&, const unsigned char*, unsigned int, unsigned int&);
+    unsigned int compile_function(Block&, const unsigned char*, unsigned int, unsigned int&);
+    unsigned int compile_data(Block&, const unsigned char*, unsigned int, unsigned int&);
+
+    // Execution helpers
+    bool execute_program(const Program&, Error&);
+    bool execute_instruction(const Block&, unsigned int, Value&);
+    bool execute_conditional(const Block&, const Block::Node&);
+    bool execute_function(const Block&, const Block::Node&, Value&);
+
+    // Cache helpers
+    const std::shared_ptr<const Block>* cache_lookup(uint64_t, const unsigned char*, unsigned int, unsigned long&);
+    void cache_store(uint64_t, const unsigned char*, unsigned int, unsigned long, const std::shared_ptr<const Block>&);
 
     // Output helpers
-    void print_block(std::ostream&, unsigned char*, unsigned int);
+    void print_block(std::ostream&, const unsigned char*, unsigned int);
     void print_indentation(std::ostream&, unsigned int);
     void print_newline(std::ostream&, unsigned int);
     
     // Auxiliary functions
-    inline void tick();
-    std::vector<std::pair<unsigned int, unsigned int> > extract_syntax(std::initializer_list<unsigned char>, unsigned char*, unsigned int, unsigned int&);
-    std::vector<std::pair<unsigned int, unsigned int> > extract_arguments(unsigned char*, unsigned int, unsigned int&);
-    std::vector<std::pair<unsigned int, unsigned int> > extract_instructions(unsigned char*, unsigned int, unsigned int&);
+    inline bool tick();
+    inline bool fail(EXCEPTIONTYPE, const char*);
+    bool extract_syntax(unsigned char, unsigned char, unsigned char, const unsigned char*, unsigned int, unsigned int&, std::vector<std::pair<unsigned int, unsigned int> >&);
+    bool extract_arguments(const unsigned char*, unsigned int, unsigned int&, std::vector<std::pair<unsigned int, unsigned int> >&);
+    bool extract_instructions(const unsigned char*, unsigned int, unsigned int&, std::vector<std::pair<unsigned int, unsigned int> >&);
     
     // Byte conversion
     bool toBool(unsigned char);
@@ -91,7 +131,23 @@ private:
     bool mInstructionLimit;
     unsigned long mInstructionCounter;
     unsigned long mInstructions;
+    bool mDetailed;
     Grammar* mGrammar;
+    Error mError;
+
+    // Value stack, holding the arguments of the functions being executed
+    std::vector<Value> mStack;
+
+    // Block cache, remembering for every gene its compiled block and the
+    // amount of instructions its validation took
+    struct CacheEntry {
+        std::vector<unsigned char> gene;
+        unsigned long instructions;
+        std::shared_ptr<const Block> block;
+    };
+    std::unordered_map<uint64_t, CacheEntry> mCache;
+    std::deque<uint64_t> mCacheOrder;
+    unsigned int mCacheCapacity;
 };
 
 
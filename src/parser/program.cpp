@@ -0,0 +1,86 @@
+/*
+ * program.cpp
+ * Evolve - Code parser (compiled program)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "program.h"
+
+
+
+////////////////////
+// CLASS ROUTINES //
+////////////////////
+
+//
+// Block
+//
+
+// Default constructor
+Block::Block() {
+    mInstructions = 0;
+    mInstructionCount = 0;
+}
+
+// Add a node, and return its index
+unsigned int Block::addNode(const Node& iNode) {
+    mNodes.push_back(iNode);
+    return mNodes.size() - 1;
+}
+
+// Add a contiguous range of children, and return its offset
+unsigned int Block::addChildren(const std::vector<unsigned int>& iChildren) {
+    unsigned int tOffset = mChildren.size();
+    mChildren.insert(mChildren.end(), iChildren.begin(), iChildren.end());
+    return tOffset;
+}
+
+// Set the root instructions
+void Block::setInstructions(const std::vector<unsigned int>& iInstructions) {
+    mInstructionCount = iInstructions.size();
+    mInstructions = addChildren(iInstructions);
+}
+
+
+//
+// Program
+//
+
+// Default constructor
+Program::Program() {
+}
+
+// Add a block
+void Program::addBlock(const std::shared_ptr<const Block>& iBlock) {
+    mBlocks.push_back(iBlock);
+}
+
+// Remove all blocks
+void Program::clear() {
+    mBlocks.clear();
+}
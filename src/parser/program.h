@@ -0,0 +1,149 @@
+/*
+ * program.h
+ * Evolve - Code parser (compiled program)
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __PROGRAM
+#define __PROGRAM
+
+// Headers
+#include <vector>
+#include <memory>
+#include "value.h"
+#include "function.h"
+
+
+//
+// Constants
+//
+
+// Node types
+enum NODETYPE {
+    NODE_CONDITIONAL,
+    NODE_FUNCTION,
+    NODE_DATA
+};
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// A compiled block
+//   all instructions of a validated gene are stored in a flat node array, in
+//   which every node refers to its children (the test and instructions of a
+//   conditional, or the parameters of a function) through a contiguous range
+//   of the child index array
+class Block {
+public:
+    // Block node
+    struct Node {
+        NODETYPE type;
+        unsigned char byte;         // conditional or function byte
+        const Function* function;   // resolved function
+        Value value;                // constant data
+        unsigned int children;      // offset in the child index array
+        unsigned int size;          // amount of children
+        unsigned int alternatives;  // amount of else-instructions (last children)
+    };
+
+    // Construction and destruction
+    Block();
+
+    // Construction helpers
+    unsigned int addNode(const Node&);
+    unsigned int addChildren(const std::vector<unsigned int>&);
+    void setInstructions(const std::vector<unsigned int>&);
+
+    // Data IO
+    unsigned int instructions() const;
+    unsigned int getInstruction(unsigned int) const;
+    const Node& getNode(unsigned int) const;
+    unsigned int getChild(unsigned int) const;
+
+private:
+    std::vector<Node> mNodes;
+    std::vector<unsigned int> mChildren;
+    unsigned int mInstructions;         // offset of the root instructions
+    unsigned int mInstructionCount;
+};
+
+// A compiled program
+//   blocks are immutable and shared, so that programs can be copied cheaply
+//   and blocks can be reused across programs
+class Program {
+public:
+    // Construction and destruction
+    Program();
+
+    // Construction helpers
+    void addBlock(const std::shared_ptr<const Block>&);
+    void clear();
+
+    // Data IO
+    unsigned int blocks() const;
+    const Block& getBlock(unsigned int) const;
+
+private:
+    std::vector<std::shared_ptr<const Block> > mBlocks;
+};
+
+
+//
+// Data IO
+//
+
+inline unsigned int Block::instructions() const {
+    return mInstructionCount;
+}
+
+inline unsigned int Block::getInstruction(unsigned int iInstruction) const {
+    return mChildren[mInstructions + iInstruction];
+}
+
+inline const Block::Node& Block::getNode(unsigned int iNode) const {
+    return mNodes[iNode];
+}
+
+inline unsigned int Block::getChild(unsigned int iChild) const {
+    return mChildren[iChild];
+}
+
+inline unsigned int Program::blocks() const {
+    return mBlocks.size();
+}
+
+inline const Block& Program::getBlock(unsigned int iBlock) const {
+    return *mBlocks[iBlock];
+}
+
+
+// Include guard
+#endif
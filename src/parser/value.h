@@ -34,6 +34,7 @@
 
 // Headers
 #include <fstream>
+#include <vector>
 #include "type.h"
 
 
@@ -66,6 +67,47 @@ private:
     int mInt;
 };
 
+// Function parameters
+//   a read-only view on a contiguous range of values, which lets the parser
+//   pass arguments straight from its value stack without copying them
+class Parameters {
+public:
+    // Construction
+    Parameters(const Value*, unsigned int);
+    Parameters(const std::vector<Value>&);
+
+    // Data IO
+    const Value& operator[](unsigned int) const;
+    unsigned int size() const;
+
+private:
+    const Value* mValues;
+    unsigned int mSize;
+};
+
+
+//
+// Parameters
+//
+
+inline Parameters::Parameters(const Value* iValues, unsigned int iSize) {
+    mValues = iValues;
+    mSize = iSize;
+}
+
+inline Parameters::Parameters(const std::vector<Value>& iValues) {
+    mValues = iValues.empty() ? 0 : &iValues[0];
+    mSize = iValues.size();
+}
+
+inline const Value& Parameters::operator[](unsigned int iIndex) const {
+    return mValues[iIndex];
+}
+
+inline unsigned int Parameters::size() const {
+    return mSize;
+}
+
 
 // Include guard
 #endif
@@ -30,6 +30,7 @@
 
 // Headers
 #include "population.h"
+#include <exception>
 
 
 
@@ -45,11 +46,14 @@
 Population::Population(Environment* inputEnvironment, const DNA& inputDNA) {
     dataDNA = new DNA(inputDNA);
     dataEnvironment = inputEnvironment;
+    dataEvaluator = new EvalSerial(inputEnvironment);
+    dataSteady = false;
 }
 
 // Destructor
 Population::~Population() {
     delete dataDNA;
+    delete dataEvaluator;
 }
 
 
@@ -63,6 +67,25 @@ const DNA* Population::get() const
 }
 
 
+//
+// Configuration
+//
+
+// Set the evaluator used to calculate fitness values (takes ownership)
+void Population::setEvaluator(Evaluator* inputEvaluator)
+{
+    delete dataEvaluator;
+    dataEvaluator = inputEvaluator;
+}
+
+// Evolve steady-state instead of by generations (for the models which
+// support it)
+void Population::setSteady(bool inputSteady)
+{
+    dataSteady = inputSteady;
+}
+
+
 //
 // Population helper functions
 //
@@ -90,6 +113,9 @@ void Population::clean(std::vector<CachedClient>& population, int start)
 }
 
 // Fill a population with the starting DNA
+//   slots which already hold a client (e.g. those culled in the previous
+//   generation) get the DNA copied into their existing storage, so after the
+//   first generation no clients nor DNA buffers get allocated anymore
 void Population::fill(std::vector<CachedClient>& population, int start)
 {
     // Copy the first clients
@@ -97,8 +123,9 @@ void Population::fill(std::vector<CachedClient>& population, int start)
     for (unsigned int i = start; i < population.size(); i++)
     {
         if (population[i].client != 0)
-            delete population[i].client;
-        population[i].client = new Client(*population[j].client);
+            *population[i].client = *population[j].client;
+        else
+            population[i].client = new Client(*population[j].client);
         population[i].fitness = population[j].fitness;
         if (++j == start)
             j = 0;
@@ -113,8 +140,7 @@ void Population::mutate(std::vector<CachedClient>& population, int start)
         population[i].client->mutate();
 
     // Calculate new fitness
-    for (unsigned int i = start; i < population.size(); i++)
-        population[i].fitness = dataEnvironment->fitness(population[i].client->get());
+    evaluate(population, start);
 
     // Sort the population
     std::sort(population.begin(), population.end());
@@ -133,9 +159,111 @@ void Population::recombine(std::vector<CachedClient>& population, int start)
     }
 
     // Calculate new fitness
-    for (unsigned int i = start; i < population.size(); i++)
-        population[i].fitness = dataEnvironment->fitness(population[i].client->get());
+    evaluate(population, start);
 
     // Sort the population
     std::sort(population.begin(), population.end());
 }
+
+// Calculate the fitness of clients
+void Population::evaluate(std::vector<CachedClient>& population, int start)
+{
+    // Collect the DNA
+    std::vector<const DNA*> tempDNA;
+    for (unsigned int i = start; i < population.size(); i++)
+        tempDNA.push_back(population[i].client->get());
+
+    // Evaluate
+    std::vector<double> tempFitness;
+    dataEvaluator->evaluate(tempDNA, tempFitness);
+    for (unsigned int i = start; i < population.size(); i++)
+        population[i].fitness = tempFitness[i-start];
+}
+
+// Evolve steady-state
+//   rather than evaluating a generation at once, a fixed amount of
+//   candidates is kept submitted to the evaluator. Every result that comes in
+//   takes the place of the worst client of the box if it isn't worse, after
+//   which a new candidate gets derived from a random client in the good
+//   region (by mutation, or by recombination with another one) and
+//   submitted in its place. This keeps the evaluator busy even when
+//   evaluation times vary a lot.
+void Population::steady(bool inputRecombine)
+{
+    // The box, and the candidates being evaluated (all clients get freed
+    // at the end, also when evolution gets interrupted by an exception)
+    std::vector<CachedClient> population(POPULATION_BOX_SIZE);
+    std::vector<Client*> candidates(POPULATION_STEADY_DEPTH, (Client*) 0);
+    std::exception_ptr tempException;
+
+    unsigned int tag;
+    double fitness;
+    try {
+        // Allocate the box, and submit the first candidates
+        init(population, dataDNA, 1);
+        fill(population, 1);
+        for (int i = 0; i < POPULATION_STEADY_DEPTH; i++) {
+            candidates[i] = new Client(*population[0].client);
+            candidates[i]->mutate();
+            dataEvaluator->submit(candidates[i]->get(), i);
+        }
+
+        // Critical fitness
+        double fitness_critical = population[0].fitness;
+
+        // Loop
+        while (dataEnvironment->condition() && dataEvaluator->collect(tag, fitness))
+        {
+            // Swap the candidate with the worst client, and move it up
+            if (fitness >= population[POPULATION_BOX_SIZE-1].fitness)
+            {
+                std::swap(candidates[tag], population[POPULATION_BOX_SIZE-1].client);
+                population[POPULATION_BOX_SIZE-1].fitness = fitness;
+                for (int i = POPULATION_BOX_SIZE-1; i > 0 && population[i-1].fitness < population[i].fitness; i--)
+                    std::swap(population[i-1], population[i]);
+            }
+
+            // Update?
+            if (population[0].fitness > fitness_critical)
+            {
+                fitness_critical = population[0].fitness;
+                *dataDNA = *population[0].client->get();
+                dataEnvironment->update(dataDNA);    // TODO: pass fitness
+            }
+
+            // Get good region
+            int threshold = POPULATION_BOX_THRESHOLD -1;
+            while (threshold > 0 && population[threshold].fitness == -1)
+                threshold--;
+
+            // Derive a new candidate
+            *candidates[tag] = *population[random_int(0, threshold+1)].client;
+            if (inputRecombine)
+                candidates[tag]->recombine(*population[random_int(0, threshold+1)].client);
+            else
+                candidates[tag]->mutate();
+            dataEvaluator->submit(candidates[tag]->get(), tag);
+        }
+    } catch (...) {
+        tempException = std::current_exception();
+    }
+
+    // Wait for the candidates still being evaluated (ignoring their errors,
+    // as they get discarded anyway)
+    while (dataEvaluator->pending() > 0) {
+        try {
+            dataEvaluator->collect(tag, fitness);
+        } catch (...) {
+        }
+    }
+
+    // Clean
+    for (int i = 0; i < POPULATION_STEADY_DEPTH; i++)
+        delete candidates[i];
+    for (int i = 0; i < POPULATION_BOX_SIZE; i++)
+        delete population[i].client;
+
+    // Propagate errors to the caller
+    if (tempException != std::exception_ptr())
+        std::rethrow_exception(tempException);
+}
@@ -35,6 +35,7 @@
 // Headers
 #include "client.h"
 #include "environment.h"
+#include "evaluator.h"
 #include "dna.h"
 #include <vector>
 
@@ -47,6 +48,10 @@
 const int POPULATION_BOX_SIZE = 50;
 const int POPULATION_BOX_THRESHOLD = 10;
 
+// Amount of candidates a steady-state population keeps in evaluation (as
+// many as a generation creates)
+const int POPULATION_STEADY_DEPTH = POPULATION_BOX_SIZE - POPULATION_BOX_THRESHOLD;
+
 
 
 //////////////////////
@@ -60,11 +65,15 @@ class Population
     public:
         // Construction and destruction
         Population(Environment* inputEnvironment, const DNA& inputDNA);
-        ~Population();
+        virtual ~Population();
 
         // Output routines
         const DNA* get() const;
 
+        // Configuration
+        void setEvaluator(Evaluator* inputEvaluator);
+        void setSteady(bool inputSteady);
+
         // Evolutionary methods
         virtual void evolve() = 0;
 
@@ -75,10 +84,16 @@ class Population
         void fill(std::vector<CachedClient>& population, int start);
         void mutate(std::vector<CachedClient>& population, int start);
         void recombine(std::vector<CachedClient>& population, int start);
+        void evaluate(std::vector<CachedClient>& population, int start);
+
+        // Steady-state evolution
+        void steady(bool inputRecombine);
 
         // Current DNA
-        const DNA* dataDNA;
+        DNA* dataDNA;
         Environment* dataEnvironment;
+        Evaluator* dataEvaluator;
+        bool dataSteady;
 };
 
 // A struct containing a client, as well as a field for its fitness
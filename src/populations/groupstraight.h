@@ -53,6 +53,12 @@ public:
 };
 
 void PopGroupStraight::evolve() {
+    // Evolve steady-state?
+    if (dataSteady) {
+        steady(true);
+        return;
+    }
+
     // Allocate new population
     std::vector<CachedClient> population(POPULATION_BOX_SIZE);
     init(population, dataDNA, 1);
@@ -80,7 +86,7 @@ void PopGroupStraight::evolve() {
         if (population[0].fitness > fitness_critical)
         {
             fitness_critical = population[0].fitness;
-            dataDNA = new DNA(*population[0].client->get());
+            *dataDNA = *population[0].client->get();
             dataEnvironment->update(dataDNA);    // TODO: pass fitness
         }
 
@@ -91,7 +97,7 @@ void PopGroupStraight::evolve() {
         // Shuffle the population
         std::vector<CachedClient>::iterator it = population.begin();
         std::advance(it, threshold+1);
-        std::random_shuffle(it, population.end());
+        std::shuffle(it, population.end(), random_generator());
 
         // Mutate new ones
         recombine(population, threshold+1);
@@ -0,0 +1,411 @@
+/*
+ * island.h
+ * Evolve - Population model for islands of clients, evolving in parallel
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Include guard
+#ifndef __ISLAND
+#define __ISLAND
+
+// Headers
+#include "../population.h"
+#include "../migration.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+
+//
+// Constants
+//
+
+// Default topology
+const TOPOLOGY ISLAND_TOPOLOGY = TOPOLOGY_RING;
+
+// Default amount of generations between migrations (which matches the
+// average rate at which PopPopulationDual swaps its elites)
+const int ISLAND_INTERVAL = 26;
+
+// Amount of migrants a queue can hold (when full, emigrants get dropped)
+const unsigned int ISLAND_QUEUE_SIZE = 4;
+
+
+
+//////////////////////
+// CLASS DEFINITION //
+//////////////////////
+
+// Single-producer single-consumer queue of migrants
+//   a ring of slots, of which only the producer moves the tail and only the
+//   consumer moves the head. The slots hold clients, which keep their DNA
+//   storage, so migrating does not allocate once every slot has been used.
+class MigrationQueue {
+public:
+    // Constructor
+    MigrationQueue(const Client& inputClient, unsigned int inputSize = ISLAND_QUEUE_SIZE);
+
+    // Queue operations (which fail if the queue is full or empty)
+    bool push(const Client& inputClient, double inputFitness);
+    bool pop(Client& outputClient, double& outputFitness);
+
+private:
+    std::vector<Client> dataClients;
+    std::vector<double> dataFitness;
+
+    // Indexes (on separate cache lines, as both sides write one of them)
+    std::atomic<unsigned int> dataHead;
+    char dataPadding[64];
+    std::atomic<unsigned int> dataTail;
+};
+
+// Island population
+//   every island evolves a box of clients like PopPopulationDual does, in
+//   its own thread and on its own clone of the environment, without any
+//   synchronisation between generations. Every few generations, islands
+//   send a copy of their elite to their neighbours through lock-free
+//   queues, and take in the migrants they received in place of their
+//   worst surviving client (if better). The first island runs in the
+//   calling thread on the original environment: it is the only one checking
+//   condition() and calling update(), with the best DNA any island found.
+//   Islands evaluate serially, so the population's evaluator goes unused;
+//   if the environment cannot be cloned, only one island evolves.
+//   With a migration transport, the first island also exchanges its elite
+//   with other processes; received migrants get evaluated again, so
+//   processes with different settings can't inject incomparable values.
+class PopIsland: public Population {
+public:
+    // Constructor
+    PopIsland(Environment* inputEnvironment, const DNA& inputDNA, unsigned int inputIslands = std::thread::hardware_concurrency(), TOPOLOGY inputTopology = ISLAND_TOPOLOGY, int inputInterval = ISLAND_INTERVAL)
+    : Population(inputEnvironment, inputDNA) {
+        dataIslands = std::max(inputIslands, 1u);
+        dataTopology = inputTopology;
+        dataInterval = std::max(inputInterval, 1);
+        dataMigration = 0;
+    }
+    ~PopIsland() {
+        delete dataMigration;
+    }
+
+    // Configuration
+    void setMigration(Migration* inputMigration);
+
+    // Required functions
+    void evolve();
+
+private:
+    // An island, evolving a population of its own
+    class Island: public Population {
+    public:
+        // Construction and destruction
+        Island(PopIsland* inputOwner, Environment* inputEnvironment, bool inputMaster)
+        : Population(inputEnvironment, *inputOwner->dataDNA) {
+            dataOwner = inputOwner;
+            dataMaster = inputMaster;
+        }
+        ~Island() {
+            if (!dataMaster)
+                delete dataEnvironment;
+        }
+
+        // Required functions
+        void evolve();
+
+        // Migration queues
+        std::vector<MigrationQueue*> dataOutgoing, dataIncoming;
+
+    private:
+        // Migration
+        void emigrate(const CachedClient& inputClient);
+        void immigrate(std::vector<CachedClient>& population, int threshold);
+        void admit(std::vector<CachedClient>& population, int threshold, const Client& inputClient, double inputFitness);
+
+        PopIsland* dataOwner;
+        bool dataMaster;
+    };
+
+    // Island management
+    void connect(std::vector<Island*>& inputIslands);
+    void run(Island* inputIsland);
+
+    // Best DNA of all islands
+    void report(const CachedClient& inputClient);
+    void publish();
+
+    // Configuration
+    unsigned int dataIslands;
+    TOPOLOGY dataTopology;
+    int dataInterval;
+    Migration* dataMigration;
+
+    // Shared state
+    std::atomic<bool> dataStop;
+    std::atomic<bool> dataChanged;
+    std::atomic<double> dataFitness;
+    std::mutex dataMutex;
+    std::exception_ptr dataException;
+    std::vector<MigrationQueue*> dataQueues;
+};
+
+
+//
+// Migration queue
+//
+
+MigrationQueue::MigrationQueue(const Client& inputClient, unsigned int inputSize)
+: dataClients(inputSize+1, inputClient), dataFitness(inputSize+1, 0) {
+    dataHead = 0;
+    dataTail = 0;
+}
+
+bool MigrationQueue::push(const Client& inputClient, double inputFitness) {
+    unsigned int tempTail = dataTail.load(std::memory_order_relaxed);
+    unsigned int tempNext = (tempTail + 1) % dataClients.size();
+    if (tempNext == dataHead.load(std::memory_order_acquire))
+        return false;
+
+    dataClients[tempTail] = inputClient;
+    dataFitness[tempTail] = inputFitness;
+    dataTail.store(tempNext, std::memory_order_release);
+    return true;
+}
+
+bool MigrationQueue::pop(Client& outputClient, double& outputFitness) {
+    unsigned int tempHead = dataHead.load(std::memory_order_relaxed);
+    if (tempHead == dataTail.load(std::memory_order_acquire))
+        return false;
+
+    outputClient = dataClients[tempHead];
+    outputFitness = dataFitness[tempHead];
+    dataHead.store((tempHead + 1) % dataClients.size(), std::memory_order_release);
+    return true;
+}
+
+
+//
+// Island population
+//
+
+// Set the transport used to migrate between processes (takes ownership)
+void PopIsland::setMigration(Migration* inputMigration) {
+    delete dataMigration;
+    dataMigration = inputMigration;
+}
+
+void PopIsland::evolve() {
+    // Create the islands (the first one using the original environment)
+    std::vector<Island*> islands;
+    islands.push_back(new Island(this, dataEnvironment, true));
+    while (islands.size() < dataIslands) {
+        Environment* tempEnvironment = dataEnvironment->clone();
+        if (tempEnvironment == 0)
+            break;
+        islands.push_back(new Island(this, tempEnvironment, false));
+    }
+    connect(islands);
+
+    // Reset the shared state
+    dataStop = false;
+    dataChanged = false;
+    dataFitness = dataEnvironment->fitness(dataDNA);
+    dataException = std::exception_ptr();
+
+    // Evolve all islands, until the first one stops
+    std::vector<std::thread> tempThreads;
+    for (unsigned int i = 1; i < islands.size(); i++)
+        tempThreads.push_back(std::thread(&PopIsland::run, this, islands[i]));
+    run(islands[0]);
+    for (unsigned int i = 0; i < tempThreads.size(); i++)
+        tempThreads[i].join();
+
+    // Clean
+    publish();
+    for (unsigned int i = 0; i < islands.size(); i++)
+        delete islands[i];
+    for (unsigned int i = 0; i < dataQueues.size(); i++)
+        delete dataQueues[i];
+    dataQueues.clear();
+
+    if (dataException != std::exception_ptr())
+        std::rethrow_exception(dataException);
+}
+
+// Create a queue for every pair of islands migrants can travel between
+void PopIsland::connect(std::vector<Island*>& inputIslands) {
+    Client tempClient(*dataDNA, dataEnvironment->alphabet());
+    unsigned int tempIslands = inputIslands.size();
+    dataQueues.assign(tempIslands*tempIslands, 0);
+    for (unsigned int from = 0; from < tempIslands; from++) {
+        for (unsigned int to = 0; to < tempIslands; to++) {
+            if (from == to)
+                continue;
+            if (dataTopology == TOPOLOGY_RING && to != (from + 1) % tempIslands)
+                continue;
+
+            MigrationQueue* tempQueue = new MigrationQueue(tempClient);
+            dataQueues[from*tempIslands + to] = tempQueue;
+            inputIslands[from]->dataOutgoing.push_back(tempQueue);
+            inputIslands[to]->dataIncoming.push_back(tempQueue);
+        }
+    }
+}
+
+// Evolve an island, and stop all others if it fails or finishes
+void PopIsland::run(Island* inputIsland) {
+    try {
+        inputIsland->evolve();
+    } catch (...) {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        if (dataException == std::exception_ptr())
+            dataException = std::current_exception();
+    }
+    dataStop = true;
+}
+
+// Save the DNA of a client if it is the best of all islands so far
+void PopIsland::report(const CachedClient& inputClient) {
+    if (inputClient.fitness <= dataFitness.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> tempLock(dataMutex);
+    if (inputClient.fitness <= dataFitness)
+        return;
+    *dataDNA = *inputClient.client->get();
+    dataFitness = inputClient.fitness;
+    dataChanged = true;
+}
+
+// Pass the best DNA on to the environment (if changed)
+void PopIsland::publish() {
+    if (!dataChanged.load(std::memory_order_acquire))
+        return;
+
+    DNA tempDNA({});
+    {
+        std::lock_guard<std::mutex> tempLock(dataMutex);
+        tempDNA = *dataDNA;
+        dataChanged = false;
+    }
+    dataEnvironment->update(&tempDNA);
+}
+
+void PopIsland::Island::evolve() {
+    // Allocate the population
+    std::vector<CachedClient> population(POPULATION_BOX_SIZE);
+    init(population, dataDNA, 1);
+    fill(population, 1);
+    mutate(population, 1);
+
+    // Loop
+    int generation = 0;
+    while (!dataOwner->dataStop.load(std::memory_order_relaxed) && (!dataMaster || dataEnvironment->condition()))
+    {
+        // Check if we got good mutations
+        if (population[0].fitness == -1)
+            throw std::string("No successfull mutations...");
+
+        // Get good region
+        int threshold = POPULATION_BOX_THRESHOLD -1;
+        while (population[threshold].fitness == -1)
+            threshold--;
+
+        // Update?
+        dataOwner->report(population[0]);
+        if (dataMaster)
+            dataOwner->publish();
+
+        // Migrate
+        if (++generation % dataOwner->dataInterval == 0) {
+            emigrate(population[0]);
+            immigrate(population, threshold);
+        }
+
+        // Refill the population
+        clean(population, threshold+1);
+        fill(population, threshold+1);
+
+        // Shuffle the population
+        std::vector<CachedClient>::iterator it = population.begin();
+        std::advance(it, threshold+1);
+        std::shuffle(it, population.end(), random_generator());
+
+        // Mutate new ones
+        recombine(population, threshold+1);
+    }
+
+    // Clean
+    for (int i = 0; i < POPULATION_BOX_SIZE; i++) {
+        if (population[i].client != 0)
+            delete population[i].client;
+    }
+}
+
+// Send a copy of a client to the neighbouring islands
+void PopIsland::Island::emigrate(const CachedClient& inputClient) {
+    if (dataMaster && dataOwner->dataMigration != 0)
+        dataOwner->dataMigration->send(*inputClient.client->get(), inputClient.fitness);
+
+    if (dataOutgoing.empty())
+        return;
+
+    if (dataOwner->dataTopology == TOPOLOGY_RANDOM)
+        dataOutgoing[random_int(0, dataOutgoing.size())]->push(*inputClient.client, inputClient.fitness);
+    else
+        for (unsigned int i = 0; i < dataOutgoing.size(); i++)
+            dataOutgoing[i]->push(*inputClient.client, inputClient.fitness);
+}
+
+// Take in the migrants received from other islands
+void PopIsland::Island::immigrate(std::vector<CachedClient>& population, int threshold) {
+    Client tempClient(*population[threshold].client);
+    double tempFitness;
+    for (unsigned int i = 0; i < dataIncoming.size(); i++) {
+        while (dataIncoming[i]->pop(tempClient, tempFitness))
+            admit(population, threshold, tempClient, tempFitness);
+    }
+
+    if (dataMaster && dataOwner->dataMigration != 0) {
+        DNA tempDNA({});
+        while (dataOwner->dataMigration->receive(tempDNA, tempFitness))
+            admit(population, threshold, Client(tempDNA, dataEnvironment->alphabet()), dataEnvironment->fitness(&tempDNA));
+    }
+}
+
+// Replace the worst surviving client by a migrant, if it is better
+void PopIsland::Island::admit(std::vector<CachedClient>& population, int threshold, const Client& inputClient, double inputFitness) {
+    if (inputFitness <= population[threshold].fitness)
+        return;
+
+    *population[threshold].client = inputClient;
+    population[threshold].fitness = inputFitness;
+    std::sort(population.begin(), population.begin() + threshold+1);
+}
+
+
+// Include guard
+#endif
@@ -93,7 +93,7 @@ void PopPopulationDual::evolve() {
         if ((*population)[0].fitness > fitness_critical)
         {
             fitness_critical = (*population)[0].fitness;
-            dataDNA = new DNA(*(*population)[0].client->get());
+            *dataDNA = *(*population)[0].client->get();
             dataEnvironment->update(dataDNA);    // TODO: pass fitness
         }
 
@@ -104,7 +104,7 @@ void PopPopulationDual::evolve() {
         // Shuffle the population
         std::vector<CachedClient>::iterator it = population->begin();
         std::advance(it, threshold+1);
-        std::random_shuffle(it, population->end());
+        std::shuffle(it, population->end(), random_generator());
 
         // Population cross-contamination!
         if (random_int(1, 27) == 13)
@@ -53,6 +53,12 @@ public:
 };
 
 void PopPopulationStraight::evolve() {
+    // Evolve steady-state?
+    if (dataSteady) {
+        steady(false);
+        return;
+    }
+
     // Allocate new population
     std::vector<CachedClient> population(POPULATION_BOX_SIZE);
     init(population, dataDNA, 1);
@@ -80,7 +86,7 @@ void PopPopulationStraight::evolve() {
         if (population[0].fitness > fitness_critical)
         {
             fitness_critical = population[0].fitness;
-            dataDNA = new DNA(*population[0].client->get());
+            *dataDNA = *population[0].client->get();
             dataEnvironment->update(dataDNA);    // TODO: pass fitness
         }
 
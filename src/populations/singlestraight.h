@@ -69,8 +69,7 @@ void PopSingleStraight::evolve() {
         if (tempFitness > dataFitness)
         {
             dataFitness = tempFitness;
-            delete dataDNA;
-            dataDNA = new DNA(*tempClient.get());
+            *dataDNA = tempClient.release();
             dataEnvironment->update(dataDNA);
         }
     }
@@ -0,0 +1,257 @@
+/*
+ * check_cache.cpp
+ * Evolve - Fitness cache test application.
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "../src/cache.h"
+#include "../src/dna.h"
+#include "../lib/check/check.h"
+
+
+//
+// Auxiliary classes
+//
+
+// Deterministic environment counting its evaluations
+//   the fitness is the length of the string, and clones share the counter
+class EnvCount : public Environment
+{
+    public:
+        EnvCount(unsigned int* inputCounter) : dataCounter(inputCounter) {}
+
+        double fitness(const DNA* inputDNA) {
+            (*dataCounter)++;
+            return inputDNA->length();
+        }
+        int alphabet() const {
+            return 256;
+        }
+        void update(const DNA* inputDNA) {
+        }
+        bool condition() {
+            return true;
+        }
+        Environment* clone() const {
+            return new EnvCount(dataCounter);
+        }
+
+    private:
+        unsigned int* dataCounter;
+};
+
+// Cache with direct access to the storage, to force hash collisions
+class EnvCacheAccess : public EnvCache
+{
+    public:
+        EnvCacheAccess(Environment* inputEnvironment) : EnvCache(inputEnvironment) {}
+
+        using EnvCache::lookup;
+        using EnvCache::store;
+};
+
+
+
+///////////
+// TESTS //
+///////////
+
+
+//
+// Lookup
+//
+
+START_TEST(test_lookup_single) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCache tempCache(&tempEnvironment);
+
+    DNA tempDNA1({1, 2, 3});
+    DNA tempDNA2({1, 2, 3, 4});
+
+    fail_unless(tempCache.fitness(&tempDNA1) == 3, "Fitness of a new string");
+    fail_unless(tempCounter == 1, "New string gets evaluated");
+    fail_unless(tempCache.fitness(&tempDNA1) == 3, "Fitness of a cached string");
+    fail_unless(tempCounter == 1, "Cached string does not get evaluated");
+    fail_unless(tempCache.fitness(&tempDNA2) == 4, "Fitness of another string");
+    fail_unless(tempCounter == 2, "Other string gets evaluated");
+
+    fail_unless(tempCache.hits() == 1, "Amount of hits");
+    fail_unless(tempCache.misses() == 2, "Amount of misses");
+}
+END_TEST
+
+START_TEST(test_lookup_batch) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCache tempCache(&tempEnvironment);
+
+    DNA tempDNA1({1});
+    DNA tempDNA2({1, 2});
+    DNA tempDNA3({1, 2, 3});
+    tempCache.fitness(&tempDNA2);
+
+    const DNA* tempBatch[] = {&tempDNA1, &tempDNA2, &tempDNA3};
+    double tempFitness[3];
+    tempCache.fitness(tempBatch, tempFitness, 3);
+    fail_unless(tempFitness[0] == 1 && tempFitness[1] == 2 && tempFitness[2] == 3, "Fitness of a batch");
+    fail_unless(tempCounter == 3, "Only the missing strings get evaluated");
+
+    tempCache.fitness(tempBatch, tempFitness, 3);
+    fail_unless(tempFitness[0] == 1 && tempFitness[1] == 2 && tempFitness[2] == 3, "Fitness of a cached batch");
+    fail_unless(tempCounter == 3, "Cached batch does not get evaluated");
+
+    fail_unless(tempCache.hits() == 4, "Amount of hits");
+    fail_unless(tempCache.misses() == 3, "Amount of misses");
+}
+END_TEST
+
+
+//
+// Storage
+//
+
+START_TEST(test_storage_eviction) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCache tempCache(&tempEnvironment, 2);
+
+    DNA tempDNA1({1});
+    DNA tempDNA2({1, 2});
+    DNA tempDNA3({1, 2, 3});
+    tempCache.fitness(&tempDNA1);
+    tempCache.fitness(&tempDNA2);
+    tempCache.fitness(&tempDNA3);
+    fail_unless(tempCounter == 3, "All strings get evaluated");
+
+    tempCache.fitness(&tempDNA2);
+    tempCache.fitness(&tempDNA3);
+    fail_unless(tempCounter == 3, "Most recent strings remain cached");
+    tempCache.fitness(&tempDNA1);
+    fail_unless(tempCounter == 4, "Oldest string gets evicted");
+}
+END_TEST
+
+START_TEST(test_storage_disabled) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCache tempCache(&tempEnvironment, 0);
+
+    DNA tempDNA({1, 2, 3});
+    tempCache.fitness(&tempDNA);
+    tempCache.fitness(&tempDNA);
+    fail_unless(tempCounter == 2, "Nothing gets cached without capacity");
+    fail_unless(tempCache.hits() == 0, "Amount of hits without capacity");
+}
+END_TEST
+
+START_TEST(test_storage_collision) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCacheAccess tempCache(&tempEnvironment);
+
+    DNA tempDNA1({1, 2, 3});
+    DNA tempDNA2({3, 2, 1});
+    double tempFitness;
+
+    tempCache.store(&tempDNA1, 42, 1);
+    fail_unless(tempCache.lookup(&tempDNA1, 42, tempFitness) && tempFitness == 1, "Stored string gets found");
+    fail_unless(!tempCache.lookup(&tempDNA2, 42, tempFitness), "Colliding string does not get found");
+
+    tempCache.store(&tempDNA2, 42, 2);
+    fail_unless(tempCache.lookup(&tempDNA2, 42, tempFitness) && tempFitness == 2, "Colliding string replaces the entry");
+    fail_unless(!tempCache.lookup(&tempDNA1, 42, tempFitness), "Replaced string does not get found");
+}
+END_TEST
+
+START_TEST(test_storage_clone) {
+    unsigned int tempCounter = 0;
+    EnvCount tempEnvironment(&tempCounter);
+    EnvCache tempCache(&tempEnvironment);
+    Environment* tempClone = tempCache.clone();
+
+    DNA tempDNA1({1, 2});
+    DNA tempDNA2({1, 2, 3});
+    tempCache.fitness(&tempDNA1);
+    fail_unless(tempClone->fitness(&tempDNA1) == 2, "Clone finds strings cached by the original");
+    tempClone->fitness(&tempDNA2);
+    fail_unless(tempCache.fitness(&tempDNA2) == 3, "Original finds strings cached by the clone");
+    fail_unless(tempCounter == 2, "Shared strings get evaluated once");
+
+    fail_unless(tempCache.hits() == 2, "Hits are shared");
+    fail_unless(tempCache.misses() == 2, "Misses are shared");
+    delete tempClone;
+}
+END_TEST
+
+
+
+//
+// Cache suite
+//
+
+
+Suite* cache_suite() {
+    Suite* s = suite_create("Cache");
+
+    // Lookup
+    TCase* tc_lookup = tcase_create("Lookup");
+    tcase_add_test(tc_lookup, test_lookup_single);
+    tcase_add_test(tc_lookup, test_lookup_batch);
+    suite_add_tcase(s, tc_lookup);
+
+    // Storage
+    TCase* tc_storage = tcase_create("Storage");
+    tcase_add_test(tc_storage, test_storage_eviction);
+    tcase_add_test(tc_storage, test_storage_disabled);
+    tcase_add_test(tc_storage, test_storage_collision);
+    tcase_add_test(tc_storage, test_storage_clone);
+    suite_add_tcase(s, tc_storage);
+
+    return s;
+}
+
+
+//
+// Runner
+//
+
+
+int main() {
+    int number_failed;
+    Suite *s = cache_suite();
+
+    // Run the suite, and be verbose with output
+    SRunner* sr = srunner_create(s);
+    srunner_run_all(sr, CK_NORMAL);
+
+    // Free resources, and return accordingly
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,314 @@
+/*
+ * check_comparison.cpp
+ * Evolve - Image comparison test application.
+ *
+ * Copyright (c) 2009 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "../src/environments/image/comparison.h"
+#include "../lib/check/check.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+//
+// Constants
+//
+
+// Largest pixel run to test (covering all vector remainders)
+const int RUN_MAX = 67;
+
+// Kernel implementations
+const KERNEL KERNELS[] = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2};
+
+// Size of the compared images (not a multiple of the grids)
+const int IMAGE_WIDTH = 37;
+const int IMAGE_HEIGHT = 23;
+
+
+
+//////////////
+// ROUTINES //
+//////////////
+
+// Fill a buffer with random bytes
+static void random_bytes(std::vector<unsigned char>& outputData)
+{
+    for (unsigned int i = 0; i < outputData.size(); i++)
+        outputData[i] = rand() & 0xFF;
+}
+
+// Reference implementations (the original comparison loops)
+static long reference_distance(const unsigned char* tempData1, const unsigned char* tempData2, int count)
+{
+    long difference = 0;
+    int db, dg, dr;
+    for (int i = 0; i < 4*count; i += 4) {
+        db = tempData1[i] - tempData2[i];
+        dg = tempData1[i+1] - tempData2[i+1];
+        dr = tempData1[i+2] - tempData2[i+2];
+        difference += sqrt(dr*dr + dg*dg + db*db);
+    }
+    return difference;
+}
+static void reference_sum(const unsigned char* rgb, int count, long* sums)
+{
+    for (int i = 0; i < count; i++) {
+        sums[0] += rgb[0];
+        sums[1] += rgb[1];
+        sums[2] += rgb[2];
+        rgb += 4;
+    }
+}
+
+// Reference difference of the averaging method, summing every block pixel
+// by pixel (weights in memory order)
+static long reference_average(const unsigned char* rgb1, const unsigned char* rgb2, int columns, int rows, const int* weights)
+{
+    long difference = 0;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < columns; c++) {
+            int x0 = c*IMAGE_WIDTH/columns, x1 = (c+1)*IMAGE_WIDTH/columns;
+            int y0 = r*IMAGE_HEIGHT/rows, y1 = (r+1)*IMAGE_HEIGHT/rows;
+            long sums1[3] = {0, 0, 0}, sums2[3] = {0, 0, 0};
+            for (int y = y0; y < y1; y++) {
+                reference_sum(rgb1 + 4*(y*IMAGE_WIDTH + x0), x1 - x0, sums1);
+                reference_sum(rgb2 + 4*(y*IMAGE_WIDTH + x0), x1 - x0, sums2);
+            }
+            long count = (x1 - x0) * (y1 - y0);
+            for (int i = 0; i < 3; i++)
+                difference += weights[i] * std::abs(sums1[i]/count - sums2[i]/count);
+        }
+    }
+    return difference;
+}
+
+
+
+///////////
+// TESTS //
+///////////
+
+
+//
+// Distance
+//
+
+START_TEST(test_distance_runs) {
+    srand(1);
+    std::vector<unsigned char> tempData1(4*(RUN_MAX+3)), tempData2(4*(RUN_MAX+3));
+    for (unsigned int k = 0; k < sizeof(KERNELS)/sizeof(KERNEL); k++) {
+        if (!kernel_select(KERNELS[k]))
+            continue;
+        for (int offset = 0; offset < 3; offset++) {
+            for (int count = 0; count <= RUN_MAX; count++) {
+                random_bytes(tempData1);
+                random_bytes(tempData2);
+                long tempExpected = reference_distance(&tempData1[4*offset], &tempData2[4*offset], count);
+                fail_unless(kernel_distance(&tempData1[4*offset], &tempData2[4*offset], count) == tempExpected, "Distance of a random pixel run");
+            }
+        }
+    }
+    kernel_select(kernel_best());
+}
+END_TEST
+
+START_TEST(test_distance_exhaustive) {
+    // All colour differences, against a random-alpha black run
+    std::vector<unsigned char> tempData1(4*256*256), tempData2(4*256*256);
+    for (unsigned int k = 0; k < sizeof(KERNELS)/sizeof(KERNEL); k++) {
+        if (!kernel_select(KERNELS[k]))
+            continue;
+        srand(2);
+        for (int b = 0; b < 256; b++) {
+            for (int i = 0; i < 256*256; i++) {
+                tempData1[4*i] = b;
+                tempData1[4*i+1] = i & 0xFF;
+                tempData1[4*i+2] = i >> 8;
+                tempData1[4*i+3] = rand() & 0xFF;
+                tempData2[4*i] = tempData2[4*i+1] = tempData2[4*i+2] = 0;
+                tempData2[4*i+3] = rand() & 0xFF;
+            }
+            long tempExpected = reference_distance(&tempData1[0], &tempData2[0], 256*256);
+            fail_unless(kernel_distance(&tempData1[0], &tempData2[0], 256*256) == tempExpected, "Distance of all colour differences");
+            fail_unless(kernel_distance(&tempData2[0], &tempData1[0], 256*256) == tempExpected, "Distance of all negative colour differences");
+        }
+    }
+    kernel_select(kernel_best());
+}
+END_TEST
+
+
+//
+// Channel sums
+//
+
+START_TEST(test_sum_runs) {
+    srand(3);
+    std::vector<unsigned char> tempData(4*(RUN_MAX+3));
+    for (unsigned int k = 0; k < sizeof(KERNELS)/sizeof(KERNEL); k++) {
+        if (!kernel_select(KERNELS[k]))
+            continue;
+        for (int offset = 0; offset < 3; offset++) {
+            for (int count = 0; count <= RUN_MAX; count++) {
+                random_bytes(tempData);
+                long tempExpected[3] = {1, 2, 3}, tempSums[3] = {1, 2, 3};
+                reference_sum(&tempData[4*offset], count, tempExpected);
+                kernel_sum(&tempData[4*offset], count, tempSums);
+                for (int c = 0; c < 3; c++)
+                    fail_unless(tempSums[c] == tempExpected[c], "Channel sum of a random pixel run");
+            }
+        }
+    }
+    kernel_select(kernel_best());
+}
+END_TEST
+
+START_TEST(test_sum_saturated) {
+    // A large white run, which would overflow narrow accumulators
+    std::vector<unsigned char> tempData(4*1024*1024, 0xFF);
+    for (unsigned int k = 0; k < sizeof(KERNELS)/sizeof(KERNEL); k++) {
+        if (!kernel_select(KERNELS[k]))
+            continue;
+        long tempSums[3] = {0, 0, 0};
+        kernel_sum(&tempData[0], 1024*1024, tempSums);
+        for (int c = 0; c < 3; c++)
+            fail_unless(tempSums[c] == 255L*1024*1024, "Channel sum of a white run");
+    }
+    kernel_select(kernel_best());
+}
+END_TEST
+
+
+//
+// Comparison strategy
+//
+
+START_TEST(test_comparison_grid) {
+    srand(4);
+    std::vector<unsigned char> tempTarget(4*IMAGE_WIDTH*IMAGE_HEIGHT), tempImage(4*IMAGE_WIDTH*IMAGE_HEIGHT);
+    random_bytes(tempTarget);
+    random_bytes(tempImage);
+
+    Comparison tempComparison(COMPARISON_AVERAGE, 32, 32);
+    tempComparison.setup(&tempTarget[0], IMAGE_WIDTH, IMAGE_HEIGHT);
+    fail_unless(tempComparison.difference(&tempTarget[0]) == 0, "Difference of the input image itself");
+
+    // Grids which do and don't divide the image, and are limited to the image
+    int tempGrids[][2] = {{32, 32}, {1, 1}, {5, 4}, {37, 23}, {64, 3}};
+    int tempWeights[3] = {1, 1, 1};
+    for (unsigned int g = 0; g < sizeof(tempGrids)/sizeof(tempGrids[0]); g++) {
+        tempComparison.setGrid(tempGrids[g][0], tempGrids[g][1]);
+        int tempColumns = std::min(tempGrids[g][0], IMAGE_WIDTH), tempRows = std::min(tempGrids[g][1], IMAGE_HEIGHT);
+        fail_unless(tempComparison.blocks() == tempColumns*tempRows, "Amount of blocks");
+        fail_unless(tempComparison.difference(&tempImage[0]) == reference_average(&tempTarget[0], &tempImage[0], tempColumns, tempRows, tempWeights), "Difference of a random image");
+    }
+}
+END_TEST
+
+START_TEST(test_comparison_remainder) {
+    // Changing the last column and row of pixels should be noticed
+    std::vector<unsigned char> tempTarget(4*IMAGE_WIDTH*IMAGE_HEIGHT, 0), tempImage(4*IMAGE_WIDTH*IMAGE_HEIGHT, 0);
+    for (int y = 0; y < IMAGE_HEIGHT; y++)
+        tempImage[4*(y*IMAGE_WIDTH + IMAGE_WIDTH-1)] = 0xFF;
+    for (int x = 0; x < IMAGE_WIDTH; x++)
+        tempImage[4*((IMAGE_HEIGHT-1)*IMAGE_WIDTH + x) + 1] = 0xFF;
+
+    Comparison tempComparison(COMPARISON_AVERAGE, 4, 4);
+    tempComparison.setup(&tempTarget[0], IMAGE_WIDTH, IMAGE_HEIGHT);
+    fail_unless(tempComparison.difference(&tempImage[0]) > 0, "Difference in the remainder pixels");
+}
+END_TEST
+
+START_TEST(test_comparison_weights) {
+    srand(5);
+    std::vector<unsigned char> tempTarget(4*IMAGE_WIDTH*IMAGE_HEIGHT), tempImage(4*IMAGE_WIDTH*IMAGE_HEIGHT);
+    random_bytes(tempTarget);
+    random_bytes(tempImage);
+
+    Comparison tempComparison(COMPARISON_AVERAGE, 6, 5);
+    tempComparison.setWeights(3, 0, 2);
+    tempComparison.setup(&tempTarget[0], IMAGE_WIDTH, IMAGE_HEIGHT);
+    int tempWeights[3] = {2, 0, 3};
+    long tempDifference = reference_average(&tempTarget[0], &tempImage[0], 6, 5, tempWeights);
+    fail_unless(tempComparison.difference(&tempImage[0]) == tempDifference, "Weighted difference");
+    fail_unless(tempComparison.similarity(tempDifference) == 1.0 - tempDifference / (255.0 * 6 * 5 * 5), "Weighted similarity");
+}
+END_TEST
+
+
+//
+// Comparison suite
+//
+
+
+Suite * comparison_suite() {
+    Suite* s = suite_create("Comparison");
+
+    // Colour distance
+    TCase* tc_distance = tcase_create("Distance");
+    tcase_add_test(tc_distance, test_distance_runs);
+    tcase_add_test(tc_distance, test_distance_exhaustive);
+    tcase_set_timeout(tc_distance, 60);
+    suite_add_tcase(s, tc_distance);
+
+    // Channel sums
+    TCase* tc_sum = tcase_create("Channel sums");
+    tcase_add_test(tc_sum, test_sum_runs);
+    tcase_add_test(tc_sum, test_sum_saturated);
+    suite_add_tcase(s, tc_sum);
+
+    // Comparison strategy
+    TCase* tc_comparison = tcase_create("Strategy");
+    tcase_add_test(tc_comparison, test_comparison_grid);
+    tcase_add_test(tc_comparison, test_comparison_remainder);
+    tcase_add_test(tc_comparison, test_comparison_weights);
+    suite_add_tcase(s, tc_comparison);
+
+    return s;
+}
+
+
+//
+// Runner
+//
+
+
+int main() {
+    int number_failed;
+    Suite *s = comparison_suite();
+
+    // Run the suite, and be verbose with output
+    SRunner* sr = srunner_create(s);
+    srunner_run_all(sr, CK_NORMAL);
+
+    // Free resources, and return accordingly
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
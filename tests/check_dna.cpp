@@ -80,6 +80,62 @@ START_TEST(test_aux_genloc) {
 }
 END_TEST
 
+START_TEST(test_aux_index) {
+    unsigned char dna1[] = {0x01, 0x02, 0x00,
+        0x03, 0x04, 0x00,
+        0x05, 0x06};
+    DNA tempDNA1(dna1, 8);
+
+    // Build the index, and modify the DNA afterwards
+    fail_unless(tempDNA1.genes() == 3, "Gene count before modification");
+    unsigned char gene1[] = {0x07, 0x08};
+    tempDNA1.insert_gene(1, gene1, 2);
+    tempDNA1.push_back_gene(gene1, 2);
+    tempDNA1.erase_gene(0);
+    unsigned char gene2[] = {0x09};
+    tempDNA1.replace_gene(2, gene2, 1);
+
+    // Compare against a freshly indexed copy of the same data
+    unsigned char* data;
+    tempDNA1.extract(0, tempDNA1.length(), data);
+    DNA tempDNA2(data, tempDNA1.length());
+    free(data);
+    fail_unless(tempDNA1.genes() == tempDNA2.genes(), "Gene count after modification");
+    for (unsigned int i = 0; i < tempDNA2.genes(); i++) {
+        fail_unless(tempDNA1.gene_start(i) == tempDNA2.gene_start(i), "Gene start index after modification");
+        fail_unless(tempDNA1.gene_end(i) == tempDNA2.gene_end(i), "Gene end index after modification");
+    }
+
+    // Erase all genes
+    while (tempDNA1.genes() > 0)
+        tempDNA1.erase_gene(0);
+    fail_unless(tempDNA1.length() == 0, "Length after erasing all genes");
+    tempDNA1.push_back_gene(gene1, 2);
+    fail_unless(tempDNA1.genes() == 1, "Gene count after reinsertion");
+}
+END_TEST
+
+START_TEST(test_aux_view) {
+    unsigned char dna1[] = {0x01, 0x02, 0x00,
+        0x00,
+        0x03, 0x04, 0x05};
+    DNA tempDNA1(dna1, 7);
+
+    Gene tempGene = tempDNA1.gene(2);
+    fail_unless(tempGene.size == 3, "Gene view size");
+    fail_unless(tempGene.data[0] == 0x03 && tempGene.data[2] == 0x05, "Gene view contents");
+    fail_unless(tempDNA1.gene(1).size == 0, "Empty gene view size");
+
+    unsigned int tempCount = 0, tempSize = 0;
+    for (DNA::const_iterator it = tempDNA1.begin(); it != tempDNA1.end(); ++it) {
+        tempCount++;
+        tempSize += (*it).size;
+    }
+    fail_unless(tempCount == 3, "Gene iterator count");
+    fail_unless(tempSize == 5, "Gene iterator sizes");
+}
+END_TEST
+
 
 //
 // Informational
@@ -112,6 +168,71 @@ START_TEST(test_inf_count) {
 }
 END_TEST
 
+START_TEST(test_inf_hash) {
+    unsigned char dna1[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a};
+    DNA tempDNA1(dna1, 10);
+    DNA tempDNA2(dna1, 10);
+    DNA tempDNA3(dna1, 9);
+
+    fail_unless(tempDNA1.hash() == tempDNA2.hash(), "Hash of equal DNA");
+    fail_unless(tempDNA1.hash() != tempDNA3.hash(), "Hash of shorter DNA");
+    tempDNA2.replace(9, dna1, 1);
+    fail_unless(tempDNA1.hash() != tempDNA2.hash(), "Hash of modified DNA");
+}
+END_TEST
+
+START_TEST(test_inf_storage) {
+    unsigned char dna1[] = {0x01, 0x02, 0x00, 0x03};
+    DNA tempDNA1(dna1, 4);
+    fail_unless(tempDNA1.capacity() == DNA_INLINE_SIZE, "Inline capacity");
+
+    // Grow onto the heap
+    for (unsigned int i = 0; i < DNA_INLINE_SIZE; i++)
+        tempDNA1.push_back(dna1, 4);
+    fail_unless(tempDNA1.length() == 4*(DNA_INLINE_SIZE+1), "Length after growing");
+    fail_unless(tempDNA1.capacity() >= tempDNA1.length(), "Capacity after growing");
+
+    // Shrink back to inline storage
+    tempDNA1.erase(4, tempDNA1.length());
+    tempDNA1.shrink_to_fit();
+    fail_unless(tempDNA1.capacity() == DNA_INLINE_SIZE, "Capacity after shrinking");
+    fail_unless(tempDNA1 == DNA(dna1, 4), "Contents after shrinking");
+
+    // Move heap storage
+    tempDNA1.reserve(2*DNA_INLINE_SIZE);
+    DNA tempDNA2(std::move(tempDNA1));
+    fail_unless(tempDNA2.capacity() == 2*DNA_INLINE_SIZE, "Capacity after move");
+    fail_unless(tempDNA2.genes() == 2, "Gene count after move");
+    fail_unless(tempDNA1.length() == 0, "Length of moved-from DNA");
+
+    // Copy assignment
+    tempDNA1 = tempDNA2;
+    fail_unless(tempDNA1 == tempDNA2, "Contents after assignment");
+}
+END_TEST
+
+START_TEST(test_inf_modified) {
+    unsigned char dna1[] = {0x01, 0x02, 0x00, 0x03, 0x04, 0x00, 0x05, 0x06};
+    DNA tempDNA1(dna1, 8);
+    fail_unless(tempDNA1.modified() == DNA_UNMODIFIED, "Unmodified after construction");
+    fail_unless(tempDNA1.modified_gene() == 3, "No modified gene after construction");
+
+    // Modify the last gene, and then the separator in front of it
+    tempDNA1.replace(7, dna1, 1);
+    fail_unless(tempDNA1.modified() == 7, "Modification offset");
+    fail_unless(tempDNA1.modified_gene() == 2, "Modified gene");
+    tempDNA1.erase(5, 6);
+    fail_unless(tempDNA1.modified() == 5, "Modification offset at separator");
+    fail_unless(tempDNA1.modified_gene() == 1, "Modified gene at separator");
+
+    // Copies start anew, moves take over the offset
+    DNA tempDNA2(tempDNA1);
+    fail_unless(tempDNA2.modified() == DNA_UNMODIFIED, "Unmodified after copy");
+    tempDNA2 = std::move(tempDNA1);
+    fail_unless(tempDNA2.modified() == 5, "Modification offset after move");
+}
+END_TEST
+
 
 //
 // Operators
@@ -141,6 +262,59 @@ START_TEST(test_op_compare) {
 END_TEST
 
 
+//
+// Serialisation
+//
+
+START_TEST(test_serial_roundtrip) {
+    unsigned char dnastring[] = {0x00,
+        0x01, 0x02, 0x03, 0x02, 0x01, 0x00,
+        0x00,
+        0x02, 0x03, 0x04, 0x03, 0x02};
+    DNA dna = DNA(dnastring, 13);
+    std::vector<unsigned char> data;
+    dna.serialize(data);
+    fail_unless(data.size() == 13 + DNA_SERIAL_OVERHEAD, "Serialised size");
+
+    // Deserialise into a string with a stale gene index
+    DNA dna_check = DNA({0x05, 0x00, 0x06});
+    fail_unless(dna_check.genes() == 2, "Initial gene count");
+    fail_unless(dna_check.deserialize(&data[0], data.size()) == (int) data.size(), "Deserialised size");
+    fail_unless(dna_check == dna, "Deserialised contents");
+    fail_unless(dna_check.genes() == 4, "Deserialised gene count");
+
+    // Strings following each other
+    DNA dna_empty = DNA({});
+    dna_empty.serialize(data);
+    fail_unless(dna_check.deserialize(&data[13 + DNA_SERIAL_OVERHEAD], DNA_SERIAL_OVERHEAD) == (int) DNA_SERIAL_OVERHEAD, "Empty string");
+    fail_unless(dna_check.length() == 0, "Empty string contents");
+}
+END_TEST
+
+START_TEST(test_serial_invalid) {
+    unsigned char dnastring[] = {0x01, 0x02, 0x00, 0x03};
+    DNA dna = DNA(dnastring, 4);
+    std::vector<unsigned char> data;
+    dna.serialize(data);
+
+    // Incomplete data
+    DNA dna_check = DNA({0x05});
+    for (unsigned int i = 0; i < data.size(); i++)
+        fail_unless(dna_check.deserialize(&data[0], i) == 0, "Incomplete data");
+
+    // Corrupted contents
+    data[5] ^= 0x10;
+    fail_unless(dna_check.deserialize(&data[0], data.size()) == -1, "Corrupted contents");
+    data[5] ^= 0x10;
+
+    // Excessive length
+    data[3] = 0xFF;
+    fail_unless(dna_check.deserialize(&data[0], data.size()) == -1, "Excessive length");
+    fail_unless(dna_check == DNA({0x05}), "Unmodified after failure");
+}
+END_TEST
+
+
 //
 // Raw modifiers
 //
@@ -690,11 +864,16 @@ Suite * dna_suite() {
     // Auxiliary functionality
     TCase* tc_aux = tcase_create("Auxiliary");
     tcase_add_test(tc_aux, test_aux_genloc);
+    tcase_add_test(tc_aux, test_aux_index);
+    tcase_add_test(tc_aux, test_aux_view);
     suite_add_tcase(s, tc_aux);
 
     // Informational routines
     TCase* tc_inf = tcase_create("Informational");
     tcase_add_test(tc_inf, test_inf_count);
+    tcase_add_test(tc_inf, test_inf_hash);
+    tcase_add_test(tc_inf, test_inf_storage);
+    tcase_add_test(tc_inf, test_inf_modified);
     suite_add_tcase(s, tc_inf);
 
     // Operators
@@ -719,6 +898,12 @@ Suite * dna_suite() {
     tcase_add_test(tc_rawmod, test_rawmod_extract_end);
     suite_add_tcase(s, tc_rawmod);
 
+    // Serialisation
+    TCase* tc_serial = tcase_create("Serialisation");
+    tcase_add_test(tc_serial, test_serial_roundtrip);
+    tcase_add_test(tc_serial, test_serial_invalid);
+    suite_add_tcase(s, tc_serial);
+
     // Gene modifiers
     TCase* tc_genemod = tcase_create("Gene modifiers");
     tcase_add_test(tc_genemod, test_genemod_erase_simple_start);
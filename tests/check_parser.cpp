@@ -0,0 +1,189 @@
+/*
+ * check_parser.cpp
+ * Evolve - Parser test application.
+ *
+ * Copyright (c) 2010 Tim Besard <tim.besard@gmail.com>
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////
+// CONFIGURATION //
+///////////////////
+
+//
+// Essential stuff
+//
+
+// Headers
+#include "../src/parser/grammars/simple.h"
+#include "../src/parser/parser.h"
+#include "../src/dna.h"
+#include "../lib/check/check.h"
+#include <string>
+
+
+
+///////////
+// TESTS //
+///////////
+
+
+//
+// Error messages
+//
+
+START_TEST(test_error_arity) {
+    SimpleGrammar tempGrammar;
+    tempGrammar.setup();
+    Parser tempParser(&tempGrammar);
+
+    // Compare a single integer
+    DNA tempDNA({
+        INSTR_OPEN,
+            TEST_LESSER,
+                ARG_OPEN,
+                    DATA_INT, 1,
+                ARG_CLOSE,
+        INSTR_CLOSE
+    });
+
+    Error tempError;
+    fail_unless(!tempParser.validate(tempDNA, tempError), "Bad arity gets reported");
+    fail_unless(std::string(tempError.what()) == "invalid function parameter count", "Bad arity error message");
+
+    std::string tempMessage;
+    try {
+        tempParser.validate(tempDNA);
+    }
+    catch (const Exception& e) {
+        tempMessage = e.what();
+    }
+    fail_unless(tempMessage == "invalid function parameter count", "Bad arity exception message");
+}
+END_TEST
+
+START_TEST(test_error_signature) {
+    SimpleGrammar tempGrammar;
+    tempGrammar.setup();
+    Parser tempParser(&tempGrammar);
+
+    // Add a boolean to an integer
+    DNA tempDNA({
+        INSTR_OPEN,
+            MATH_PLUS,
+                ARG_OPEN,
+                    DATA_BOOL, 1,
+                ARG_SEP,
+                    DATA_INT, 1,
+                ARG_CLOSE,
+        INSTR_CLOSE
+    });
+    Program tempProgram = tempParser.compile(tempDNA);
+
+    Error tempError;
+    fail_unless(!tempParser.execute(tempProgram, tempError), "Bad signature gets reported");
+    fail_unless(std::string(tempError.what()) == "input parameters did not respect function signature", "Bad signature error message");
+
+    std::string tempMessage, tempDetails;
+    try {
+        tempParser.execute(tempProgram);
+    }
+    catch (const Exception& e) {
+        tempMessage = e.what();
+        tempDetails = e.details();
+    }
+    fail_unless(tempMessage == "input parameters did not respect function signature", "Bad signature exception message");
+    fail_unless(tempDetails == "got called with [(bool), (int)] while function signature is [(int), (int)]", "Bad signature exception details");
+
+    // The non-throwing flavour should not be affected by a previous detailed run
+    fail_unless(!tempParser.execute(tempProgram, tempError), "Bad signature gets reported again");
+}
+END_TEST
+
+START_TEST(test_error_handler) {
+    SimpleGrammar tempGrammar;
+    tempGrammar.setup();
+    Parser tempParser(&tempGrammar);
+
+    // Divide by zero (computed, as a zero byte would separate genes)
+    DNA tempDNA({
+        INSTR_OPEN,
+            MATH_DIV,
+                ARG_OPEN,
+                    DATA_INT, 1,
+                ARG_SEP,
+                    MATH_MIN,
+                        ARG_OPEN,
+                            DATA_INT, 1,
+                        ARG_SEP,
+                            DATA_INT, 1,
+                        ARG_CLOSE,
+                ARG_CLOSE,
+        INSTR_CLOSE
+    });
+    Program tempProgram = tempParser.compile(tempDNA);
+
+    std::string tempMessage;
+    try {
+        tempParser.execute(tempProgram);
+    }
+    catch (const Exception& e) {
+        tempMessage = e.what();
+    }
+    fail_unless(tempMessage == "division by zero", "Function failure exception message");
+}
+END_TEST
+
+
+
+//
+// Parser suite
+//
+
+
+Suite* parser_suite() {
+    Suite* s = suite_create("Parser");
+
+    // Error messages
+    TCase* tc_error = tcase_create("Error messages");
+    tcase_add_test(tc_error, test_error_arity);
+    tcase_add_test(tc_error, test_error_signature);
+    tcase_add_test(tc_error, test_error_handler);
+    suite_add_tcase(s, tc_error);
+
+    return s;
+}
+
+
+//
+// Runner
+//
+
+
+int main() {
+    int number_failed;
+    Suite *s = parser_suite();
+
+    // Run the suite, and be verbose with output
+    SRunner* sr = srunner_create(s);
+    srunner_run_all(sr, CK_NORMAL);
+
+    // Free resources, and return accordingly
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}